@@ -137,7 +137,11 @@ namespace codesmith
 			void make_time() {
 				std::time_t t_now = std::chrono::system_clock::to_time_t(
 					std::chrono::system_clock::now());
+#ifdef _WIN32
 				localtime_s(&m_stm, &t_now);
+#else
+				localtime_r(&t_now, &m_stm);
+#endif
 			}
 
 		private:
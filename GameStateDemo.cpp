@@ -7,8 +7,12 @@
  * are here on the Game application side which is implemented with PGE.
  */
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 #define OLC_PGE_APPLICATION
 #include "pge/olcPixelGameEngine.h"
@@ -20,27 +24,87 @@ using namespace codesmith::gamestate;
 
 /**
  * States and layers
- * This demo does not use layers within states. Each state handles rendering 
- * of the state.
+ * Most states here render everything themselves. The pause state shows its
+ * screen with a cached layer instead, drawn once and then only composited.
  */
 
+/**
+ * Layer target for PGE, each layer gets a PGE layer of its own which the GPU
+ * composites. PGE uploads a layer only in frames it was made the draw target,
+ * so a cached layer is uploaded when it redraws and never otherwise. PGE puts
+ * layer 0, where the states draw, in front of the others, and each layer
+ * created later behind the ones before it.
+ */
+class PGELayerTarget : public LayerTarget
+{
+public:
+	PGELayerTarget(olc::PixelGameEngine* pge) : 
+		m_pge(pge), m_layer(uint8_t(pge->CreateLayer())) { }
+
+	void begin() override {
+		m_pge->SetDrawTarget(m_layer);
+	}
+
+	// Drawing goes back to layer 0, decals included
+	void end() override {
+		m_pge->SetDrawTarget(nullptr);
+	}
+
+	void composite() override {
+		m_pge->EnableLayer(m_layer, true);
+	}
+
+	void hide() override {
+		m_pge->EnableLayer(m_layer, false);
+	}
+
+private:
+	olc::PixelGameEngine* m_pge;
+	uint8_t m_layer;
+};
+
+class GSDLayerPauseScreen : public GameStateLayer
+{
+public:
+	GSDLayerPauseScreen(uint16_t id, olc::PixelGameEngine* pge) :
+		GameStateLayer(id, true), m_pge(pge) { }
+
+	// Only runs when the cache needs drawing, not every frame
+	bool update(float) override {
+		m_pge->Clear(olc::BLUE);
+		int32_t w = m_pge->ScreenWidth(), h = m_pge->ScreenHeight();
+		m_pge->FillRect(w / 4, h / 3, w / 2, h / 3, olc::DARK_BLUE);
+		m_pge->DrawRect(w / 4, h / 3, w / 2, h / 3, olc::WHITE);
+		m_pge->DrawString(w / 2 - 48, h / 2 - 8, "PAUSED", olc::WHITE, 2);
+		m_pge->DrawString(w / 2 - 88, h / 2 + 16, "Press SPACE to resume", olc::WHITE);
+		return true;
+	}
+private:
+	olc::PixelGameEngine* m_pge;
+};
+
 class GSDStatePrimary : public GameState
 {
 public:
-	GSDStatePrimary(uint16_t id, olc::PixelGameEngine* pge) :
+	GSDStatePrimary(uint16_t id, olc::PixelGameEngine* pge, olc::AssetWatcher& assets) :
 		GameState(id), m_pge(pge) { 
 		m_background.Load("assets/desert.png");
+		// Edit the image while the demo runs and it shows up on the next frame
+		assets.Watch(m_background, "assets/desert.png");
 		LOG_INFO() << "Constructed state " << id;
 	};
 	GSDStatePrimary() = delete;
 	~GSDStatePrimary() = default;
 	bool update(float fElapsedTime) override {
 		m_pge->Clear(olc::RED);
+		if(m_background.Decal()) m_pge->DrawDecal(olc::vf2d(0.0f, 0.0f), m_background.Decal());
 
 		// Cause update for all owned layers, if any
 		GameState::update(fElapsedTime);
 
-		std::string txt = "Rendering state: " + std::to_string(id());
+		std::string txt = "Rendering state: " + std::to_string(id()) +
+			", frame " + std::to_string(time().frameIndex) + 
+			", session " + std::to_string(time().session()) + " s";
 		m_pge->DrawStringDecal(olc::vf2d(10.0f, 10.0f), txt);
 		return true;
 	}
@@ -82,15 +146,25 @@ public:
 		GameState(id), m_pge(pge) {
 		m_background.Load("assets/desert.png");
 		m_background.Load("assets/paused.png");
+		// Nothing moves while paused, no need to render at full rate
+		setIdle(true);
+		// Nor to redraw the pause screen, it is drawn once and kept
+		std::shared_ptr<GameStateLayer> screen = std::make_shared<GSDLayerPauseScreen>(0, pge);
+		screen->setTarget(std::make_shared<PGELayerTarget>(pge));
+		screen->setCaching(GameStateLayer::Caching::STATIC);
+		addLayer(screen);
+		// Only bound while paused
+		actions().bindState(InputEvent::Device::KEYBOARD, olc::Key::SPACE, 0);
 		LOG_INFO() << "Constructed state " << id;
 	}
 
 	~GSDStatePause() = default;
 
 	bool update(float fElapsedTime) override {
-		m_pge->Clear(olc::BLUE);
+		// Layer 0 is in front of the pause screen, see through it
+		m_pge->Clear(olc::BLANK);
 
-		// Cause update for all owned layers, if any
+		// Cause update for all owned layers, the pause screen covers all
 		GameState::update(fElapsedTime);
 
 		std::string txt = "Rendering  state: " + std::to_string(id());
@@ -120,43 +194,80 @@ public:
 		LOG_INFO() << "PGEApplication destroyed";
 	}
 
+	// Records the session to a file, for replay()
+	void recordTo(const std::string& file) { m_recordFile = file; };
+
 public:
 	bool OnUserCreate() override
 	{
 		LOG_INFO() << "PGEApplication::OnUserCreate() initializing";
+		// Do not burn a whole core redrawing the same screen
+		SetFrameRateLimit(60.0f);
+		SetIdleFrameRate(20.0f);
+		if(!m_recordFile.empty() && StartRecording(m_recordFile) != olc::OK) {
+			LOG_INFO() << "Cannot record to " << m_recordFile;
+		}
+		m_assets = std::make_unique<olc::AssetWatcher>();
+		m_assets->SetOnReload([](const olc::AssetWatcher::Reload& reload) {
+			LOG_INFO() << "Reloaded " << reload.sFile << (reload.result == olc::OK ? "" : " FAILED") <<
+				", decoded in " << reload.fDecodeMs << " ms, on screen " << reload.fLatencyMs <<
+				" ms after the change";
+		});
 		m_stateManager = std::make_unique<GameStateManager>();
-		std::shared_ptr<GameState> state1 = std::make_shared<GSDStatePrimary>(0, this);
+		std::shared_ptr<GameState> state1 = std::make_shared<GSDStatePrimary>(0, this, *m_assets);
 		std::shared_ptr<GameState> state2 = std::make_shared<GSDStateSecondary>(1, this);
 		std::shared_ptr<GameState> state3 = std::make_shared<GSDStatePause>(2, this);
 		m_stateManager->addState(state1, true);
 		m_stateManager->addState(state2);
 		m_stateManager->addState(state3);
 
+		// Keys that work in every state
+		ActionMap& keys = m_stateManager->actions();
+		keys.bindState(InputEvent::Device::KEYBOARD, olc::Key::F1, 0);
+		keys.bindState(InputEvent::Device::KEYBOARD, olc::Key::F2, 1);
+		keys.bindState(InputEvent::Device::KEYBOARD, olc::Key::F3, 2);
+		keys.bind(InputEvent::Device::KEYBOARD, olc::Key::ESCAPE,
+			[this](const InputEvent&) { m_quit = true; });
+		// Quick save and load, a key snapshot can be restored at any time
+		keys.bind(InputEvent::Device::KEYBOARD, olc::Key::F5,
+			[this](const InputEvent&) { m_stateManager->snapshot(m_quickSave, true); });
+		keys.bind(InputEvent::Device::KEYBOARD, olc::Key::F9,
+			[this](const InputEvent&) { m_stateManager->restore(m_quickSave); });
+
 		LOG_INFO() << m_stateManager->count() << 
 			" are now managed by the GameStateManager";
 		return true;
 	}
 
-	bool OnUserUpdate(float fElapsedTime) override
+	bool OnUserUpdate(float) override
 	{
-		// Update state(s)
-		bool continue_loop = m_stateManager->update(fElapsedTime);
+		// Input first, only the key changes of this frame are looked up in
+		// the active state's bindings and then in the global ones
+		for(const olc::InputEvent& e : GetInputEvents()) {
+			InputEvent event;
+			event.device = e.device == olc::InputEvent::Device::MOUSE ?
+				InputEvent::Device::MOUSE : InputEvent::Device::KEYBOARD;
+			event.code = e.nCode;
+			event.pressed = e.bPressed;
+			m_stateManager->input(event);
+		}
 
-		std::string txt = "Press F1, F2 and F3 to switch states, ESC to quit";
+		// Update state(s), with the engine's exact monotonic timing
+		FrameTime time;
+		time.frameNs = GetFrameTimeNs();
+		time.sessionNs = GetSessionTimeNs();
+		bool continue_loop = m_stateManager->update(time);
+
+		std::string txt = "Press F1, F2 and F3 to switch states, F5 to save, F9 to load, ESC to quit";
 		DrawStringDecal(olc::vf2d(10.0f, 25.0f), txt, olc::BLUE);
 
-		if(GetKey(olc::Key::F1).bPressed) {
-			m_stateManager->activateState(0);
-		} else if(GetKey(olc::Key::F2).bPressed) {
-			m_stateManager->activateState(1);
-		} else if(GetKey(olc::Key::F3).bPressed) {
-			m_stateManager->activateState(2);
-		}
-		else if(GetKey(olc::Key::ESCAPE).bPressed) {
-			continue_loop = false;
-		}
-		
-		return continue_loop;
+		olc::FrameStats stats = GetFrameStats();
+		txt = "Frame " + std::to_string(stats.fMeanMs) + " ms, jitter " + 
+			std::to_string(stats.fStdDevMs) + " ms, p99 " + std::to_string(stats.fP99Ms) + " ms";
+		DrawStringDecal(olc::vf2d(10.0f, 40.0f), txt, olc::WHITE);
+
+		SetIdle(m_stateManager->idle());
+		return continue_loop && !m_quit;
 	}
 
 	/**
@@ -169,13 +280,65 @@ public:
 		return true;
 	}
 private:
+	std::unique_ptr<olc::AssetWatcher> m_assets;
 	std::unique_ptr<GameStateManager> m_stateManager;
+	std::string m_recordFile;
+	bool m_quit = false;
+	Snapshot m_quickSave;
 };
 
-int main()
+/**
+ * Runs a recorded session without a window as fast as possible, and reports
+ * how long the updates took. Each frame's time goes to the timings file, if
+ * given, so sessions can be kept as a benchmark of the state updates.
+ */
+int replay(PGEApplication& demo, const std::string& session, const std::string& timings)
+{
+	std::vector<int64_t> updateNs;
+	if(demo.Replay(session, updateNs) != olc::OK) {
+		std::cerr << "Cannot replay " << session << std::endl;
+		return 1;
+	}
+	if(!timings.empty()) {
+		std::ofstream csv(timings);
+		csv << "frame,update_ns\n";
+		for(std::size_t i = 0; i < updateNs.size(); ++i) {
+			csv << i << "," << updateNs[i] << "\n";
+		}
+	}
+	if(!updateNs.empty()) {
+		std::vector<int64_t> sorted(updateNs);
+		std::sort(sorted.begin(), sorted.end());
+		double total = 0.0;
+		for(int64_t ns : sorted) total += double(ns);
+		std::cout << sorted.size() << " frames, update mean " << total / sorted.size() * 1e-6 <<
+			" ms, median " << sorted[sorted.size() / 2] * 1e-6 <<
+			" ms, p99 " << sorted[sorted.size() * 99 / 100] * 1e-6 <<
+			" ms, max " << sorted.back() * 1e-6 << " ms" << std::endl;
+	}
+	return 0;
+}
+
+/**
+ * GameStateDemo                            runs the demo
+ * GameStateDemo --record session.bin       runs it and records the session
+ * GameStateDemo --replay session.bin [timings.csv]
+ */
+int main(int argc, char* argv[])
 {
+	std::vector<std::string> args(argv + 1, argv + argc);
 	PGEApplication demo;
-	if(demo.Construct(1024, 768, 1, 1))
-		demo.Start();
+	if(!demo.Construct(1024, 768, 1, 1)) {
+		return 1;
+	}
+	if(args.size() >= 2 && args[0] == "--replay") {
+		return replay(demo, args[1], args.size() >= 3 ? args[2] : "");
+	}
+	if(args.size() >= 2 && args[0] == "--record") {
+		demo.recordTo(args[1]);
+	}
+	// Update the states while the previous frame is being rendered
+	demo.SetPipelinedUpdate(true);
+	demo.Start();
 	return 0;
 }
@@ -81,15 +81,234 @@
 #ifndef __GAMESTATESYSTEM_H_DEFINED__
 #define __GAMESTATESYSTEM_H_DEFINED__
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include "DebugLogger.h"
 
 namespace codesmith {
 namespace gamestate {
+	/**
+	 * Timing of one update in whole nanoseconds, ideally from a monotonic
+	 * clock. Lets states step deterministically and does not lose precision
+	 * in long sessions the way an accumulated float would.
+	 */
+	struct FrameTime
+	{
+		int64_t frameNs = 0;		// Since the previous update
+		int64_t sessionNs = 0;		// Accumulated, including this update
+		uint64_t frameIndex = 0;	// 0 on the first update, set by the manager
+
+		inline float elapsed() const { return float(double(frameNs) * 1e-9); };
+		inline double session() const { return double(sessionNs) * 1e-9; };
+	};
+
+	/**
+	 * A key or button going down or up, as the application's engine reports
+	 * it. The codes are the engine's own, the state system only passes them on.
+	 */
+	struct InputEvent
+	{
+		enum class Device : uint8_t { KEYBOARD, MOUSE };
+		Device device = Device::KEYBOARD;
+		uint32_t code = 0;
+		bool pressed = false;
+	};
+
+	/**
+	 * Bytes states and layers save themselves into for a snapshot. The memory
+	 * is kept from one snapshot to the next, so after the first few nothing
+	 * is allocated. Values are copied as they are in memory, so snapshots
+	 * only load back into the same build on the same machine.
+	 */
+	class SnapshotArena
+	{
+	public:
+		void reserve(std::size_t bytes) { if(bytes > m_data.size()) m_data.resize(bytes); };
+		inline std::size_t size() const { return m_size; };
+		inline const uint8_t* data() const { return m_data.data(); };
+
+		void write(const void* data, std::size_t bytes) {
+			if(m_size + bytes > m_data.size()) {
+				m_data.resize(std::max(m_size + bytes, m_data.size() * 2));
+			}
+			if(bytes > 0) std::memcpy(m_data.data() + m_size, data, bytes);
+			m_size += bytes;
+		}
+		template<typename T> void write(const T& value) {
+			static_assert(std::is_trivially_copyable<T>::value, "Write the members one by one");
+			write(&value, sizeof(T));
+		}
+
+		// False, and nothing read, if the bytes are not there
+		bool read(void* data, std::size_t bytes) {
+			if(bytes > m_limit - m_read) return false;
+			if(bytes > 0) std::memcpy(data, m_data.data() + m_read, bytes);
+			m_read += bytes;
+			return true;
+		}
+		template<typename T> bool read(T& value) {
+			static_assert(std::is_trivially_copyable<T>::value, "Read the members one by one");
+			return read(&value, sizeof(T));
+		}
+
+	private:
+		friend class GameStateManager;
+		std::vector<uint8_t> m_data;
+		std::size_t m_size = 0;
+		// What a load may read, one state's bytes at a time
+		std::size_t m_read = 0;
+		std::size_t m_limit = 0;
+	};
+
+	/**
+	 * A saved moment of a GameStateManager: which state was active and what
+	 * every state and layer saved. Stored as the bytes that changed since
+	 * the snapshot before, which for a game that changes a little each frame
+	 * is a small fraction of the whole. A key snapshot stands on its own.
+	 */
+	class Snapshot
+	{
+	public:
+		// Counts the snapshots of a manager from 1, 0 for none taken yet
+		inline uint64_t sequence() const { return m_sequence; };
+		// The snapshot this one is the difference to, 0 for a key snapshot
+		inline uint64_t base() const { return m_base; };
+		// Stored size and the size of what the states saved
+		inline std::size_t size() const { return m_data.size(); };
+		inline std::size_t rawSize() const { return m_rawSize; };
+
+	private:
+		friend class GameStateManager;
+		uint64_t m_sequence = 0;
+		uint64_t m_base = 0;
+		std::size_t m_rawSize = 0;
+		std::vector<uint8_t> m_data;
+	};
+
+	class GameStateManager;
+
+	/**
+	 * Binds key and button changes to actions, a callback or a switch to
+	 * another state. The bindings are compiled into a table indexed by the
+	 * code, so an event costs one lookup however many bindings there are.
+	 * Codes are used as indices, keep them small like engine key codes.
+	 */
+	class ActionMap
+	{
+	public:
+		using Action = std::function<void(const InputEvent&)>;
+
+		// Runs the action when the key goes down, or up with onRelease
+		void bind(InputEvent::Device device, uint32_t code, Action action, bool onRelease = false) {
+			add(device, code, onRelease, std::move(action), -1);
+		}
+		// Activates the state when the key goes down, or up with onRelease
+		void bindState(InputEvent::Device device, uint32_t code, uint16_t state, bool onRelease = false) {
+			add(device, code, onRelease, nullptr, state);
+		}
+		void unbind(InputEvent::Device device, uint32_t code, bool onRelease = false) {
+			InputEvent trigger;
+			trigger.device = device;
+			trigger.code = code;
+			trigger.pressed = !onRelease;
+			auto i = std::find_if(m_bindings.begin(), m_bindings.end(),
+				[&](const Binding& b) { return slot(b.trigger) == slot(trigger); });
+			if(i != m_bindings.end()) {
+				m_bindings.erase(i);
+				m_compiled = false;
+			}
+		}
+		void clear() { m_bindings.clear(); m_compiled = false; };
+		inline std::size_t size() const { return m_bindings.size(); };
+
+		// Runs what the event is bound to, true if it was bound to anything.
+		// State switches need the manager, they are skipped without one.
+		bool dispatch(const InputEvent& event, GameStateManager* manager);
+
+	private:
+		struct Binding
+		{
+			InputEvent trigger;
+			// Shared so that dispatch() can hold on to it cheaply
+			std::shared_ptr<const Action> action;
+			int32_t state = -1;
+		};
+
+		static std::size_t slot(const InputEvent& event) {
+			return (std::size_t(event.code) << 2) | (std::size_t(event.device) << 1) |
+				std::size_t(event.pressed);
+		}
+
+		void add(InputEvent::Device device, uint32_t code, bool onRelease, Action action, int32_t state) {
+			Binding binding;
+			binding.trigger.device = device;
+			binding.trigger.code = code;
+			binding.trigger.pressed = !onRelease;
+			if(action) binding.action = std::make_shared<const Action>(std::move(action));
+			binding.state = state;
+			// Binding a key again replaces what it was bound to
+			auto i = std::find_if(m_bindings.begin(), m_bindings.end(),
+				[&](const Binding& b) { return slot(b.trigger) == slot(binding.trigger); });
+			if(i != m_bindings.end()) {
+				*i = std::move(binding);
+			} else {
+				m_bindings.emplace_back(std::move(binding));
+			}
+			m_compiled = false;
+		}
+
+		void compile() {
+			std::size_t size = 0;
+			for(auto& b : m_bindings) size = std::max(size, slot(b.trigger) + 1);
+			m_table.assign(size, -1);
+			for(std::size_t i = 0; i < m_bindings.size(); ++i) {
+				m_table[slot(m_bindings[i].trigger)] = int32_t(i);
+			}
+			m_compiled = true;
+		}
+
+		std::vector<Binding> m_bindings;
+		// Binding index of each slot, -1 for none
+		std::vector<int32_t> m_table;
+		bool m_compiled = true;
+	};
+
+	/**
+	 * Surface a layer draws into, kept between frames. The state system
+	 * draws nothing itself, so the application implements this on top of its
+	 * renderer, for example as an engine layer the GPU composites, or an
+	 * offscreen sprite shown with a decal.
+	 */
+	class LayerTarget
+	{
+	public:
+		virtual ~LayerTarget() { };
+		// Sends drawing into the target, just before the layer updates
+		virtual void begin() = 0;
+		// Sends drawing back to where it was, after the layer has updated
+		virtual void end() = 0;
+		// Shows the target, every frame, whether the layer updated or not
+		virtual void composite() = 0;
+		// Stops showing the target, when its state is left
+		virtual void hide() { };
+	};
+
 	class GameStateLayer
 	{
 	public:
+		/**
+		 * NONE updates the layer every frame. STATIC updates it once into its
+		 * target and from then on only composites the target, until
+		 * invalidate() is called. ON_DEMAND also asks dirty() every frame.
+		 */
+		enum class Caching : uint8_t { NONE, STATIC, ON_DEMAND };
+
 		GameStateLayer(uint16_t id, bool enabled) : 
 			m_id(id), m_enabled(true) { };
 		virtual ~GameStateLayer() { };
@@ -100,11 +319,52 @@ namespace gamestate {
 		inline uint16_t id() const { return m_id; };
 		inline bool enabled() const { return m_enabled; };
 		inline bool setEnabled(bool enabled) { m_enabled = enabled; };
+		// Timing of the update in progress
+		inline const FrameTime& time() const { return m_time; };
 		virtual bool update(float fElapsedTime) = 0;
+		// Return true to consume the event, layers below do not see it then.
+		// Events bound in actions() are consumed before they get here.
+		virtual bool input(const InputEvent&) { return false; };
+		inline ActionMap& actions() { return m_actions; };
+
+		// Layers of a state update in increasing order, so a higher order
+		// draws over a lower one. Equal orders keep the order they were added.
+		inline int32_t order() const { return m_order; };
+		inline void setOrder(int32_t order) { m_order = order; };
+
+		// Draws the layer into a surface of its own, nullptr for none
+		void setTarget(std::shared_ptr<LayerTarget> target) {
+			m_target = target;
+			if(!m_target) m_caching = Caching::NONE;
+			m_cacheValid = false;
+		}
+		inline LayerTarget* target() const { return m_target.get(); };
+		// Retained rendering, for layers that rarely change such as menus.
+		// Needs a target to keep the output in, stays NONE without one.
+		void setCaching(Caching caching) {
+			m_caching = m_target ? caching : Caching::NONE;
+			m_cacheValid = false;
+		}
+		inline Caching caching() const { return m_caching; };
+		// The next frame updates the layer into its target again
+		inline void invalidate() { m_cacheValid = false; };
+		// For ON_DEMAND layers, true when the cached output is out of date
+		virtual bool dirty() const { return false; };
+
+		// Snapshots, load() reads back what save() wrote, false on failure
+		virtual void save(SnapshotArena&) const { };
+		virtual bool load(SnapshotArena&) { return true; };
 
 	private:
+		friend class GameState;
 		uint16_t m_id;
 		bool m_enabled;
+		FrameTime m_time;
+		int32_t m_order = 0;
+		ActionMap m_actions;
+		Caching m_caching = Caching::NONE;
+		std::shared_ptr<LayerTarget> m_target;
+		bool m_cacheValid = false;
 	};
 
 	class GameState
@@ -117,26 +377,142 @@ namespace gamestate {
 		std::size_t layers() const { return m_layers.size(); };
 	public: // Public interface
 		inline uint16_t id() const { return m_id; };
+		// Timing of the update in progress
+		inline const FrameTime& time() const { return m_time; };
+		// A state with nothing moving, for example a pause menu, can ask the
+		// application to drop to a low tick rate while it is active
+		inline bool idle() const { return m_idle; };
+		inline void setIdle(bool idle) { m_idle = idle; };
 		void addLayer(std::shared_ptr<GameStateLayer> layer) {
 			// Note here we allow duplicate layers, so you can reuse
 			// your existing layers
 			m_layers.emplace_back(layer);
 		}
+		/**
+		 * Snapshots, saves and loads the layers in the order they were
+		 * added. A state with data of its own overrides these and calls
+		 * them, like update().
+		 */
+		virtual void save(SnapshotArena& arena) const {
+			for(auto& layer : m_layers) layer->save(arena);
+		}
+		virtual bool load(SnapshotArena& arena) {
+			for(auto& layer : m_layers) {
+				if(!layer->load(arena)) return false;
+			}
+			return true;
+		}
+
+		/**
+		 * Rollback, the state keeps its simulation in one block of plain
+		 * data, such as a struct of arrays with no pointers into itself. The
+		 * manager copies it aside every frame and copies it back on a rewind,
+		 * so everything the next update depends on has to be in it.
+		 */
+		template<typename T> void setSimulation(T& data) {
+			static_assert(std::is_trivially_copyable<T>::value, "Keep the simulation in plain data");
+			setSimulation(&data, sizeof(T));
+		}
+		void setSimulation(void* data, std::size_t bytes) {
+			m_simulation = static_cast<uint8_t*>(data);
+			m_simulationBytes = data ? bytes : 0;
+			m_history.clear();
+		}
+		inline std::size_t simulationBytes() const { return m_simulationBytes; };
+
+		// Makes every cached layer redraw, for example after a resize
+		void invalidateLayers() {
+			for(auto& layer : m_layers) layer->invalidate();
+		}
+		// Stops showing the targets of the layers, when the state is left
+		void hideLayers() {
+			for(auto& layer : m_layers) {
+				if(layer->m_target) layer->m_target->hide();
+			}
+		}
 
 	public: 
+		/**
+		 * Offers the event to the layers from the topmost down, until one
+		 * consumes it, and then to the state's own actions. Returns true if
+		 * it was consumed.
+		 */
+		virtual bool input(const InputEvent& event) {
+			sortLayers();
+			for(auto i = m_sorted.rbegin(); i != m_sorted.rend(); ++i) {
+				GameStateLayer* layer = i->first;
+				if(layer->m_actions.dispatch(event, m_manager) || layer->input(event)) {
+					return true;
+				}
+			}
+			return m_actions.dispatch(event, m_manager);
+		}
+		// Input bindings of the state, after those of its layers
+		inline ActionMap& actions() { return m_actions; };
+
 		virtual bool update(float fElapsedTime) {
-			auto i = m_layers.begin();
+			sortLayers();
+			auto i = m_sorted.begin();
 			bool res = true;
-			while(res && i != m_layers.end()) {
-				res = i->get()->update(fElapsedTime);
+			while(res && i != m_sorted.end()) {
+				GameStateLayer* layer = i->first;
+				layer->m_time = m_time;
+				if(!layer->m_target) {
+					res = layer->update(fElapsedTime);
+				} else {
+					// Cached layers only update when their output is stale,
+					// so their target is not touched on the other frames
+					if(layer->m_caching == GameStateLayer::Caching::NONE ||
+						!layer->m_cacheValid ||
+						(layer->m_caching == GameStateLayer::Caching::ON_DEMAND && layer->dirty())) {
+						layer->m_target->begin();
+						res = layer->update(fElapsedTime);
+						layer->m_target->end();
+						// One that bailed out left its target half drawn
+						layer->m_cacheValid = res;
+					}
+					layer->m_target->composite();
+				}
 				++i;
 			}
 			return true;
 		}
 
 	private:
+		// Orders change rarely, so this is usually just the check. Ties go
+		// by the position the layer was added at.
+		void sortLayers() {
+			auto before = [](const SortedLayer& a, const SortedLayer& b) {
+				return a.first->order() < b.first->order() ||
+					(a.first->order() == b.first->order() && a.second < b.second);
+			};
+			if(m_sorted.size() != m_layers.size() ||
+				!std::is_sorted(m_sorted.begin(), m_sorted.end(), before)) {
+				m_sorted.clear();
+				for(std::size_t i = 0; i < m_layers.size(); ++i) {
+					m_sorted.emplace_back(m_layers[i].get(), i);
+				}
+				std::sort(m_sorted.begin(), m_sorted.end(), before);
+			}
+		}
+
+	private:
+		friend class GameStateManager;
 		std::vector<std::shared_ptr<GameStateLayer>> m_layers;
+		// The layers in update order, with the position they were added at
+		using SortedLayer = std::pair<GameStateLayer*, std::size_t>;
+		std::vector<SortedLayer> m_sorted;
+		ActionMap m_actions;
+		// Set when added, for state switches bound in the action maps
+		GameStateManager* m_manager = nullptr;
 		uint16_t m_id;
+		bool m_idle = false;
+		FrameTime m_time;
+		// Rollback, copies of the simulation one after another, one per frame
+		uint8_t* m_simulation = nullptr;
+		std::size_t m_simulationBytes = 0;
+		std::vector<uint8_t> m_history;
+		uint64_t m_historySince = 0;
 	};
 
 	/**
@@ -154,6 +530,7 @@ namespace gamestate {
 		void addState(std::shared_ptr<GameState> state, bool isDefault = false) {
 			auto st = std::find(m_states.begin(), m_states.end(), state);
 			if(st == m_states.end()) {
+				state->m_manager = this;
 				m_states.emplace_back(state);
 				LOG_INFO() << "Added new state, id = " << state->id();
 				if(isDefault) {
@@ -164,9 +541,10 @@ namespace gamestate {
 		}
 
 		void activateState(uint16_t id) {
-			if(m_currentState->id() != id) {
+			if(!m_currentState || m_currentState->id() != id) {
 				for(auto s : m_states) { 
 					if(s->id() == id) {
+						if(m_currentState) m_currentState->hideLayers();
 						m_currentState = s.get();
 						LOG_INFO() << "Activated state " << m_currentState->id();
 					}
@@ -176,11 +554,195 @@ namespace gamestate {
 
 		std::size_t count() const { return m_states.size(); };
 
+		// True when the active state has asked for idle ticking
+		bool idle() const { return m_currentState && m_currentState->idle(); };
+
 		bool update(float fElapsedTime) {
+			FrameTime time;
+			time.frameNs = int64_t(double(fElapsedTime) * 1e9);
+			time.sessionNs = m_time.sessionNs + time.frameNs;
+			return update(time);
+		}
+
+		/**
+		 * As above but with exact timing, for example from the engine's
+		 * monotonic clock or a recorded session. The active state and its
+		 * layers can read it back with time(). The frame index is the
+		 * manager's own count of updates, whatever the caller put there, so
+		 * that it goes back with rewind().
+		 */
+		bool update(const FrameTime& time) {
 			bool res = true;
+			m_time = time;
+			m_time.frameIndex = m_updates++;
 
 			if(m_currentState) {
-				res = m_currentState->update(fElapsedTime);
+				m_currentState->m_time = m_time;
+				res = m_currentState->update(m_time.elapsed());
+			}
+			if(!m_rollback.empty()) record();
+			return res;
+		}
+
+		inline const FrameTime& time() const { return m_time; };
+
+		/**
+		 * Routes an input event to the active state, and then to the
+		 * manager's own actions if the state did not consume it. Only the
+		 * active state and its layers see it. Returns true if consumed.
+		 */
+		bool input(const InputEvent& event) {
+			if(m_currentState && m_currentState->input(event)) return true;
+			return m_actions.dispatch(event, this);
+		}
+		// Bindings that hold in every state, such as keys switching states
+		inline ActionMap& actions() { return m_actions; };
+
+		/**
+		 * Keeps the simulation of every state, the active state and the
+		 * timing as they were at the start of each of the last frames, before
+		 * that frame's input, so rewind() can go back up to frames - 1
+		 * updates. 0 turns it off. Only what states set with setSimulation()
+		 * is kept, and all of it is copied every update.
+		 */
+		void setRollback(std::size_t frames) {
+			m_rollback.assign(frames, RollbackFrame());
+			for(auto& state : m_states) state->m_history.clear();
+			if(frames > 0) record();
+		}
+		inline std::size_t rollback() const { return m_rollback.size(); };
+
+		/**
+		 * Goes back to the start of the update that many updates ago. The
+		 * application then feeds the input of those frames again, corrected
+		 * where it has learned better, and updates through them. False if
+		 * that frame is no longer kept, and nothing changes then.
+		 */
+		bool rewind(std::size_t frames) {
+			const std::size_t n = m_rollback.size();
+			if(n == 0 || frames >= n || frames > m_updates) return false;
+			const uint64_t frame = m_updates - frames;
+			const RollbackFrame& saved = m_rollback[std::size_t(frame % n)];
+			if(saved.frame != frame) return false;
+			for(auto& state : m_states) {
+				if(state->m_simulationBytes && state->m_historySince > frame) return false;
+			}
+
+			for(auto& state : m_states) {
+				const std::size_t bytes = state->m_simulationBytes;
+				if(bytes == 0) continue;
+				std::memcpy(state->m_simulation, state->m_history.data() + std::size_t(frame % n) * bytes, bytes);
+				state->invalidateLayers();
+			}
+			m_time = saved.time;
+			m_updates = frame;
+			GameState* current = nullptr;
+			for(auto& state : m_states) {
+				if(state->id() == saved.active) current = state.get();
+			}
+			if(current != m_currentState) {
+				if(m_currentState) m_currentState->hideLayers();
+				m_currentState = current;
+			}
+			return true;
+		}
+
+		// Memory for the snapshots, so taking the first ones does not allocate
+		void reserveSnapshots(std::size_t bytes) {
+			m_raw.reserve(bytes);
+			m_capture.reserve(bytes);
+		}
+
+		/**
+		 * Saves the active state, the timing and every state into the
+		 * snapshot. It is stored as the difference to the snapshot taken or
+		 * restored last, unless key is set or there was none.
+		 */
+		void snapshot(Snapshot& snapshot, bool key = false) {
+			SnapshotArena& arena = m_capture;
+			arena.m_size = 0;
+			const uint16_t active = m_currentState ? m_currentState->id() : NO_STATE;
+			const uint32_t states = uint32_t(m_states.size());
+			arena.write(active);
+			arena.write(states);
+			arena.write(m_time);
+			arena.write(m_updates);
+			for(auto& state : m_states) {
+				// Each state's bytes are counted, so a load cannot overrun them
+				const uint16_t id = state->id();
+				arena.write(id);
+				const std::size_t at = arena.size();
+				arena.write(uint64_t(0));
+				state->save(arena);
+				const uint64_t bytes = arena.size() - at - sizeof(uint64_t);
+				std::memcpy(arena.m_data.data() + at, &bytes, sizeof(bytes));
+			}
+			// Whole words, for the delta
+			while(arena.size() % 8) arena.write(uint8_t(0));
+
+			const bool delta = !key && m_rawSequence != 0;
+			encodeDelta(delta ? &m_raw : nullptr, arena, snapshot.m_data);
+			snapshot.m_sequence = ++m_sequence;
+			snapshot.m_base = delta ? m_rawSequence : 0;
+			snapshot.m_rawSize = arena.size();
+			std::swap(m_raw, m_capture);
+			m_rawSequence = snapshot.m_sequence;
+		}
+
+		/**
+		 * Returns to a snapshot. A key snapshot can always be restored, one
+		 * stored as a difference only when the snapshot it is the difference
+		 * to was the one taken or restored last, or when it is that one. The
+		 * layers redraw their caches afterwards. False if it cannot be
+		 * restored or a state failed to load, which may leave the states
+		 * partly restored.
+		 */
+		bool restore(const Snapshot& snapshot) {
+			if(snapshot.m_sequence == 0) return false;
+			if(snapshot.m_sequence != m_rawSequence) {
+				if(snapshot.m_base != 0 && snapshot.m_base != m_rawSequence) return false;
+				if(!decodeDelta(snapshot.m_base != 0, snapshot.m_data, m_raw)) {
+					m_rawSequence = 0;
+					return false;
+				}
+				m_rawSequence = snapshot.m_sequence;
+			}
+
+			SnapshotArena& arena = m_raw;
+			arena.m_read = 0;
+			arena.m_limit = arena.m_size;
+			uint16_t active = NO_STATE;
+			uint32_t states = 0;
+			if(!arena.read(active) || !arena.read(states) || !arena.read(m_time) ||
+				!arena.read(m_updates)) {
+				return false;
+			}
+			bool res = true;
+			for(uint32_t i = 0; i < states; ++i) {
+				uint16_t id = 0;
+				uint64_t bytes = 0;
+				if(!arena.read(id) || !arena.read(bytes) || bytes > arena.m_size - arena.m_read) {
+					return false;
+				}
+				const std::size_t end = arena.m_read + std::size_t(bytes);
+				arena.m_limit = end;
+				for(auto& state : m_states) {
+					if(state->id() == id) {
+						res = state->load(arena) && res;
+						state->invalidateLayers();
+						break;
+					}
+				}
+				arena.m_read = end;
+				arena.m_limit = arena.m_size;
+			}
+			GameState* current = nullptr;
+			for(auto& state : m_states) {
+				if(state->id() == active) current = state.get();
+			}
+			if(current != m_currentState) {
+				if(m_currentState) m_currentState->hideLayers();
+				m_currentState = current;
 			}
 			return res;
 		}
@@ -190,8 +752,141 @@ namespace gamestate {
 		// Hard pointer used, all states are owned and the life cycle is managed 
 		// by this class.
 		GameState* m_currentState = nullptr;
+		FrameTime m_time;
+		uint64_t m_updates = 0;
+		ActionMap m_actions;
+
+		// Snapshots. m_raw holds what the last one taken or restored saved.
+		static const uint16_t NO_STATE = 0xFFFF;
+		SnapshotArena m_raw;
+		SnapshotArena m_capture;
+		uint64_t m_sequence = 0;
+		uint64_t m_rawSequence = 0;
+
+		// Rollback, a ring of the last frames, indexed by frame modulo its size
+		struct RollbackFrame
+		{
+			uint64_t frame = ~uint64_t(0);
+			FrameTime time;
+			uint16_t active = NO_STATE;
+		};
+		std::vector<RollbackFrame> m_rollback;
+
+		// Copies aside where the next update starts from
+		void record() {
+			const std::size_t n = m_rollback.size();
+			const std::size_t slot = std::size_t(m_updates % n);
+			RollbackFrame& saved = m_rollback[slot];
+			saved.frame = m_updates;
+			saved.time = m_time;
+			saved.active = m_currentState ? m_currentState->id() : NO_STATE;
+			for(auto& state : m_states) {
+				const std::size_t bytes = state->m_simulationBytes;
+				if(bytes == 0) continue;
+				if(state->m_history.size() != n * bytes) {
+					state->m_history.resize(n * bytes);
+					state->m_historySince = m_updates;
+				}
+				std::memcpy(state->m_history.data() + slot * bytes, state->m_simulation, bytes);
+			}
+		}
+
+		static void putVarint(std::vector<uint8_t>& out, uint64_t n) {
+			while(n >= 0x80) { out.push_back(uint8_t(n) | 0x80); n >>= 7; }
+			out.push_back(uint8_t(n));
+		}
+		static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& n) {
+			n = 0;
+			for(int shift = 0; shift < 64 && p < end; shift += 7) {
+				n |= uint64_t(*p & 0x7F) << shift;
+				if(!(*p++ & 0x80)) return true;
+			}
+			return false;
+		}
+
+		/**
+		 * The size, then runs of unchanged and changed words, each as the
+		 * number of unchanged bytes, the number of changed bytes and those
+		 * XORed with what was there before. Without a base everything is
+		 * compared to zeros. Both sizes are whole words.
+		 */
+		static void encodeDelta(const SnapshotArena* base, const SnapshotArena& next,
+			std::vector<uint8_t>& out) {
+			out.clear();
+			putVarint(out, next.size());
+			const uint8_t* a = base ? base->data() : nullptr;
+			const uint8_t* b = next.data();
+			const std::size_t common = base ? std::min(base->size(), next.size()) : 0;
+			const std::size_t n = next.size();
+			auto changes = [&](std::size_t i) {
+				uint64_t x = 0, y;
+				if(i < common) std::memcpy(&x, a + i, 8);
+				std::memcpy(&y, b + i, 8);
+				return x ^ y;
+			};
+			std::size_t i = 0, done = 0;
+			while(i < n) {
+				if(changes(i) == 0) { i += 8; continue; }
+				const std::size_t start = i;
+				while(i < n && changes(i) != 0) i += 8;
+				putVarint(out, start - done);
+				putVarint(out, i - start);
+				const std::size_t at = out.size();
+				out.resize(at + (i - start));
+				for(std::size_t j = start; j < i; j += 8) {
+					const uint64_t x = changes(j);
+					std::memcpy(out.data() + at + (j - start), &x, 8);
+				}
+				done = i;
+			}
+		}
+
+		// Applies a delta to what its base saved, in place
+		static bool decodeDelta(bool hasBase, const std::vector<uint8_t>& in, SnapshotArena& raw) {
+			const uint8_t* p = in.data();
+			const uint8_t* end = p + in.size();
+			uint64_t size = 0;
+			if(!getVarint(p, end, size) || size % 8) return false;
+			const std::size_t before = hasBase ? raw.m_size : 0;
+			raw.reserve(std::size_t(size));
+			if(before < size) std::memset(raw.m_data.data() + before, 0, std::size_t(size) - before);
+			raw.m_size = std::size_t(size);
+			std::size_t i = 0;
+			while(p < end) {
+				uint64_t skip = 0, bytes = 0;
+				if(!getVarint(p, end, skip) || !getVarint(p, end, bytes)) return false;
+				if(skip > size - i || bytes > size - i - skip || bytes > uint64_t(end - p) ||
+					(skip | bytes) % 8) {
+					return false;
+				}
+				i += std::size_t(skip);
+				uint8_t* dst = raw.m_data.data() + i;
+				for(std::size_t j = 0; j < bytes; j += 8) {
+					uint64_t x, y;
+					std::memcpy(&x, dst + j, 8);
+					std::memcpy(&y, p + j, 8);
+					x ^= y;
+					std::memcpy(dst + j, &x, 8);
+				}
+				p += bytes;
+				i += std::size_t(bytes);
+			}
+			return true;
+		}
 	};
 
+	inline bool ActionMap::dispatch(const InputEvent& event, GameStateManager* manager) {
+		if(!m_compiled) compile();
+		const std::size_t i = slot(event);
+		if(i >= m_table.size() || m_table[i] < 0) return false;
+		// Held on to, the action may well change the bindings
+		const int32_t state = m_bindings[m_table[i]].state;
+		const std::shared_ptr<const Action> action = m_bindings[m_table[i]].action;
+		if(state >= 0 && manager) manager->activateState(uint16_t(state));
+		if(action) (*action)(event);
+		return true;
+	}
+
 } // namespace gamestate
 } // namespace codesmith
 
@@ -0,0 +1,440 @@
+/**
+ * State system and rasterizer benchmark suite
+ *
+ * Times the GameStateManager adding, switching and updating states at scale,
+ * updating and routing input through the layers of a state, the CPU drawing
+ * primitives of the engine, decal submission and ResourcePack loading. No
+ * window is opened, the engine runs on its headless renderer.
+ *
+ * The results go to stdout as JSON, one entry per case with the median and
+ * the best time per operation over the repeats. Keep a run as the baseline
+ * and compare later ones against it:
+ *
+ *     gsm_bench > base.json
+ *     gsm_bench --compare base.json             runs, then compares
+ *     gsm_bench --compare base.json new.json    compares two saved runs
+ *
+ * A case has regressed when its median is slower than the baseline's by more
+ * than the threshold, and the exit code is 1 then.
+ *
+ * Options:
+ *     --repeats N       times each case is run, 7 by default
+ *     --filter TEXT     only the cases with TEXT in their name
+ *     --states N        states in the manager cases, 1000 by default
+ *     --threshold PCT   allowed slow down when comparing, 10 by default
+ *     --out FILE        writes the JSON to FILE instead of stdout
+ *
+ * Built by CMake as the gsm_bench target, see README.md.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <regex>
+
+#define OLC_PGE_APPLICATION
+#include "../pge/olcPixelGameEngine.h"
+#include "../GameStateSystem.h"
+
+using namespace codesmith::gamestate;
+
+namespace
+{
+	struct Result
+	{
+		std::string name;
+		uint64_t ops = 0;
+		double medianNs = 0.0;	// Per operation
+		double bestNs = 0.0;
+	};
+
+	// Swallows the log of addState() and activateState(), which goes to
+	// std::cerr, its cost still counts. Progress is shown on std::clog.
+	struct NullBuffer : public std::streambuf
+	{
+		int overflow(int c) override { return c; }
+	};
+
+	class Suite
+	{
+	public:
+		Suite(int repeats, const std::string& filter) : m_repeats(repeats), m_filter(filter) { }
+
+		/**
+		 * Runs setup and then times body, repeats times. Each body does ops
+		 * operations, the result is the time per operation.
+		 */
+		template<typename Setup, typename Body>
+		void run(const std::string& name, uint64_t ops, Setup&& setup, Body&& body)
+		{
+			if (!m_filter.empty() && name.find(m_filter) == std::string::npos) return;
+			std::vector<double> vNs;
+			for (int r = 0; r < m_repeats; r++)
+			{
+				setup();
+				auto t0 = std::chrono::steady_clock::now();
+				body();
+				auto t1 = std::chrono::steady_clock::now();
+				vNs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / double(ops));
+			}
+			std::sort(vNs.begin(), vNs.end());
+			Result res;
+			res.name = name;
+			res.ops = ops;
+			res.medianNs = vNs[vNs.size() / 2];
+			res.bestNs = vNs.front();
+			std::clog << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+				<< std::setw(14) << res.medianNs << " ns/op" << std::setw(14) << res.bestNs << " best\n";
+			m_results.push_back(res);
+		}
+
+		const std::vector<Result>& results() const { return m_results; }
+
+	private:
+		int m_repeats;
+		std::string m_filter;
+		std::vector<Result> m_results;
+	};
+
+	// Does nothing, so what is timed is the state system around it
+	class NullLayer : public GameStateLayer
+	{
+	public:
+		NullLayer(uint16_t id) : GameStateLayer(id, true) { }
+		bool update(float) override { m_updates++; return true; }
+		uint64_t m_updates = 0;
+	};
+
+	class NullState : public GameState
+	{
+	public:
+		NullState(uint16_t id) : GameState(id) { }
+	};
+
+	FrameTime frameTime(uint64_t frame)
+	{
+		FrameTime t;
+		t.frameNs = 16666667;
+		t.sessionNs = int64_t(frame + 1) * t.frameNs;
+		return t;
+	}
+
+	void benchStates(Suite& suite, uint16_t nStates)
+	{
+		std::unique_ptr<GameStateManager> manager;
+		std::vector<std::shared_ptr<GameState>> vStates;
+		auto create = [&]
+		{
+			manager = std::make_unique<GameStateManager>();
+			vStates.clear();
+			for (uint16_t i = 0; i < nStates; i++) vStates.push_back(std::make_shared<NullState>(i));
+		};
+		auto add = [&]
+		{
+			for (uint16_t i = 0; i < nStates; i++) manager->addState(vStates[i], i == 0);
+		};
+		suite.run("state.addState", nStates, create, add);
+
+		// The manager from the last repeat above, with every state in it
+		if (!manager) { create(); add(); }
+		const uint64_t nSwitches = 10000;
+		suite.run("state.activateState", nSwitches, [] {}, [&]
+		{
+			for (uint64_t i = 0; i < nSwitches; i++) manager->activateState(uint16_t((i * 7919) % nStates));
+		});
+
+		const uint64_t nUpdates = 200000;
+		manager->activateState(0);
+		suite.run("state.update", nUpdates, [] {}, [&]
+		{
+			for (uint64_t i = 0; i < nUpdates; i++) manager->update(frameTime(i));
+		});
+	}
+
+	void benchLayers(Suite& suite)
+	{
+		const uint16_t nLayers = 256;
+		const uint64_t nFrames = 2000;
+		GameStateManager manager;
+		auto state = std::make_shared<NullState>(0);
+		for (uint16_t i = 0; i < nLayers; i++)
+		{
+			auto layer = std::make_shared<NullLayer>(i);
+			// A few different orders, so the layers are sorted once
+			layer->setOrder(int32_t(i % 5));
+			state->addLayer(layer);
+		}
+		manager.addState(state, true);
+
+		suite.run("layers.update", nFrames * nLayers, [] {}, [&]
+		{
+			for (uint64_t i = 0; i < nFrames; i++) manager.update(frameTime(i));
+		});
+
+		// Nothing is bound and no layer consumes, so every event visits them all
+		InputEvent event;
+		event.code = 42;
+		event.pressed = true;
+		suite.run("layers.input", nFrames * nLayers, [] {}, [&]
+		{
+			for (uint64_t i = 0; i < nFrames; i++) manager.input(event);
+		});
+	}
+
+	void benchDrawing(Suite& suite, olc::PixelGameEngine& pge)
+	{
+		std::mt19937 rng(7);
+		const olc::vi2d vSize = { pge.ScreenWidth(), pge.ScreenHeight() };
+		std::uniform_int_distribution<int32_t> X(-32, vSize.x), Y(-32, vSize.y);
+		std::vector<olc::vi2d> vPos(10000);
+		for (auto& v : vPos) v = { X(rng), Y(rng) };
+
+		olc::Sprite sprite(64, 64);
+		for (int32_t y = 0; y < 64; y++)
+			for (int32_t x = 0; x < 64; x++)
+				sprite.SetPixel(x, y, olc::Pixel(uint8_t(x * 4), uint8_t(y * 4), 128, uint8_t((x ^ y) * 4)));
+
+		pge.SetDrawTarget(nullptr);
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+
+		const uint64_t nClears = 100;
+		suite.run("pge.Clear", nClears, [] {}, [&]
+		{
+			for (uint64_t i = 0; i < nClears; i++) pge.Clear(olc::Pixel(uint8_t(i), 32, 64));
+		});
+
+		suite.run("pge.FillRect", vPos.size(), [] {}, [&]
+		{
+			for (size_t i = 0; i < vPos.size(); i++) pge.FillRect(vPos[i], { 48, 48 }, olc::Pixel(uint32_t(i * 2654435761u) | 0xFF000000));
+		});
+
+		suite.run("pge.DrawSprite", vPos.size(), [] {}, [&]
+		{
+			for (const auto& v : vPos) pge.DrawSprite(v, &sprite);
+		});
+
+		// Blending every pixel it writes, one call per pixel
+		const int32_t nSide = 256;
+		suite.run("pge.Draw.alpha", uint64_t(nSide) * nSide, [&] { pge.SetPixelMode(olc::Pixel::ALPHA); }, [&]
+		{
+			for (int32_t y = 0; y < nSide; y++)
+				for (int32_t x = 0; x < nSide; x++)
+					pge.Draw(x, y, olc::Pixel(uint8_t(x), uint8_t(y), 200, uint8_t(x + y)));
+		});
+
+		suite.run("pge.DrawSprite.alpha", vPos.size(), [&] { pge.SetPixelMode(olc::Pixel::ALPHA); }, [&]
+		{
+			for (const auto& v : vPos) pge.DrawSprite(v, &sprite);
+		});
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+
+		const std::string sText = "The quick brown fox jumps over the lazy dog 0123456789";
+		const uint64_t nStrings = 2000;
+		suite.run("pge.DrawString", nStrings, [] {}, [&]
+		{
+			for (uint64_t i = 0; i < nStrings; i++) pge.DrawString(vPos[i], sText, olc::WHITE);
+		});
+
+		// Submission only, the instances are dropped before each repeat
+		olc::Decal decal(&sprite);
+		auto& layer = pge.GetLayers()[0];
+		suite.run("pge.DrawDecal", vPos.size(), [&] { layer.vecDecalInstance.clear(); }, [&]
+		{
+			for (const auto& v : vPos) pge.DrawDecal(olc::vf2d(v), &decal);
+		});
+		layer.vecDecalInstance.clear();
+	}
+
+	void benchPacks(Suite& suite)
+	{
+		_gfs::path dir = _gfs::temp_directory_path() / "gsm_bench_pack";
+		_gfs::create_directories(dir);
+
+		// Sprite dumps with some structure, so the LZ pack is realistic
+		std::mt19937 rng(1234);
+		std::vector<std::string> vFiles;
+		for (int i = 0; i < 16; i++)
+		{
+			std::vector<char> v(256 * 256 * 4);
+			for (size_t j = 0; j < v.size(); j++)
+				v[j] = char(((j >> 2) % 256) ^ ((j % 4 == 3) ? 0 : (rng() & 7)));
+			const std::string sFile = (dir / ("sprite" + std::to_string(i) + ".raw")).string();
+			std::ofstream ofs(sFile, std::ofstream::binary);
+			ofs.write(v.data(), v.size());
+			vFiles.push_back(sFile);
+		}
+
+		const std::string sKey = "BenchKey";
+		for (auto codec : { olc::ResourceCodec::RAW, olc::ResourceCodec::LZ })
+		{
+			const bool bLZ = codec == olc::ResourceCodec::LZ;
+			const std::string sPack = (dir / (bLZ ? "lz.dat" : "raw.dat")).string();
+			{
+				olc::ResourcePack pack;
+				for (auto& f : vFiles) pack.AddFile(f, codec);
+				pack.SavePack(sPack, sKey);
+			}
+			suite.run(bLZ ? "pack.load.lz" : "pack.load.raw", 1, [] {}, [&]
+			{
+				olc::ResourcePack pack;
+				pack.LoadPack(sPack, sKey);
+				for (auto& f : vFiles) pack.GetFileBuffer(f);
+			});
+		}
+
+		std::error_code ec;
+		_gfs::remove_all(dir, ec);
+	}
+
+	// Runs the drawing cases once the engine is set up, then stops it
+	class BenchEngine : public olc::PixelGameEngine
+	{
+	public:
+		BenchEngine(Suite& suite) : m_suite(suite) { sAppName = "gsm_bench"; }
+		bool OnUserCreate() override
+		{
+			benchDrawing(m_suite, *this);
+			return false;
+		}
+
+	private:
+		Suite& m_suite;
+	};
+
+	bool runEngine(Suite& suite)
+	{
+		// No window needed, it never gets past OnUserCreate()
+		BenchEngine engine(suite);
+		return engine.Construct(1280, 720, 1, 1) == olc::OK && engine.StartHeadless() == olc::OK;
+	}
+
+	std::string toJson(const std::vector<Result>& vResults, int repeats)
+	{
+		std::ostringstream os;
+		os << std::fixed << std::setprecision(3);
+		os << "{\n  \"suite\": \"gsm_bench\",\n  \"repeats\": " << repeats << ",\n  \"cases\": [\n";
+		for (size_t i = 0; i < vResults.size(); i++)
+		{
+			const Result& r = vResults[i];
+			os << "    { \"name\": \"" << r.name << "\", \"ops\": " << r.ops << ", \"median_ns\": " << r.medianNs
+				<< ", \"best_ns\": " << r.bestNs << " }" << (i + 1 < vResults.size() ? "," : "") << "\n";
+		}
+		os << "  ]\n}\n";
+		return os.str();
+	}
+
+	// Reads back what toJson() wrote, not JSON in general
+	bool fromJson(const std::string& sFile, std::vector<Result>& vResults)
+	{
+		std::ifstream ifs(sFile);
+		if (!ifs) return false;
+		std::string s((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+		std::regex entry("\\{\\s*\"name\"\\s*:\\s*\"([^\"]+)\"[^}]*\"median_ns\"\\s*:\\s*([-+0-9.eE]+)[^}]*\"best_ns\"\\s*:\\s*([-+0-9.eE]+)");
+		for (auto i = std::sregex_iterator(s.begin(), s.end(), entry); i != std::sregex_iterator(); ++i)
+		{
+			Result r;
+			r.name = (*i)[1];
+			r.medianNs = std::stod((*i)[2]);
+			r.bestNs = std::stod((*i)[3]);
+			vResults.push_back(r);
+		}
+		return !vResults.empty();
+	}
+
+	// Returns true if nothing got slower than the threshold allows
+	bool compare(const std::vector<Result>& vBase, const std::vector<Result>& vNew, double fThreshold)
+	{
+		bool bOk = true;
+		std::cout << std::left << std::setw(28) << "case" << std::right << std::setw(14) << "base ns/op"
+			<< std::setw(14) << "new ns/op" << std::setw(10) << "change" << "\n" << std::fixed << std::setprecision(1);
+		for (const Result& n : vNew)
+		{
+			auto b = std::find_if(vBase.begin(), vBase.end(), [&](const Result& r) { return r.name == n.name; });
+			std::cout << std::left << std::setw(28) << n.name << std::right;
+			if (b == vBase.end())
+			{
+				std::cout << std::setw(14) << "-" << std::setw(14) << n.medianNs << "    not in the baseline\n";
+				continue;
+			}
+			const double fChange = (n.medianNs / b->medianNs - 1.0) * 100.0;
+			const bool bRegressed = fChange > fThreshold;
+			bOk = bOk && !bRegressed;
+			std::cout << std::setw(14) << b->medianNs << std::setw(14) << n.medianNs << std::setw(9) << std::showpos
+				<< fChange << "%" << std::noshowpos << (bRegressed ? "  REGRESSED" : (fChange < -fThreshold ? "  faster" : "")) << "\n";
+		}
+		for (const Result& b : vBase)
+		{
+			if (std::none_of(vNew.begin(), vNew.end(), [&](const Result& r) { return r.name == b.name; }))
+				std::cout << std::left << std::setw(28) << b.name << std::right << "    not run\n";
+		}
+		std::cout << (bOk ? "\nNo regressions" : "\nRegressions") << " over " << fThreshold << "%\n";
+		return bOk;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int repeats = 7;
+	int nStates = 1000;
+	double fThreshold = 10.0;
+	std::string sFilter, sOut;
+	std::vector<std::string> vCompare;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		const bool bValue = i + 1 < argc;
+		if (arg == "--repeats" && bValue) repeats = std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--filter" && bValue) sFilter = argv[++i];
+		else if (arg == "--states" && bValue) nStates = std::min(std::max(1, std::atoi(argv[++i])), 65535);
+		else if (arg == "--threshold" && bValue) fThreshold = std::atof(argv[++i]);
+		else if (arg == "--out" && bValue) sOut = argv[++i];
+		else if (arg == "--compare" && bValue)
+		{
+			vCompare.push_back(argv[++i]);
+			if (i + 1 < argc && argv[i + 1][0] != '-') vCompare.push_back(argv[++i]);
+		}
+		else
+		{
+			std::cerr << "Usage: gsm_bench [--repeats N] [--filter TEXT] [--states N] [--out FILE]\n"
+				"                 [--compare BASE.json [NEW.json]] [--threshold PCT]\n";
+			return 2;
+		}
+	}
+
+	std::vector<Result> vBase, vNew;
+	if (!vCompare.empty() && !fromJson(vCompare[0], vBase))
+	{
+		std::cerr << "Cannot read " << vCompare[0] << "\n";
+		return 2;
+	}
+	if (vCompare.size() == 2)
+	{
+		if (!fromJson(vCompare[1], vNew))
+		{
+			std::cerr << "Cannot read " << vCompare[1] << "\n";
+			return 2;
+		}
+		return compare(vBase, vNew, fThreshold) ? 0 : 1;
+	}
+
+	Suite suite(repeats, sFilter);
+	NullBuffer null;
+	std::streambuf* log = std::cerr.rdbuf(&null);
+	benchStates(suite, uint16_t(nStates));
+	benchLayers(suite);
+	const bool bEngine = runEngine(suite);
+	benchPacks(suite);
+	std::cerr.rdbuf(log);
+	if (!bEngine)
+	{
+		std::cerr << "Cannot run the engine headless\n";
+		return 2;
+	}
+
+	const std::string sJson = toJson(suite.results(), repeats);
+	if (!sOut.empty()) std::ofstream(sOut) << sJson;
+	else if (vCompare.empty()) std::cout << sJson;
+	if (vCompare.empty()) return 0;
+	return compare(vBase, suite.results(), fThreshold) ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+/**
+ * Software rasterizer benchmark
+ *
+ * Draws the same scene of rectangles, circles, triangles and sprites, in a
+ * mix of pixel modes, into a 1280x720 sprite. First immediately, then with
+ * SetDeferredDrawing() on for an increasing number of threads. Each deferred
+ * frame is checked to be identical to the immediate one, and the time per
+ * frame and speed up over immediate drawing are reported. Last, a cloud of
+ * small particle triangles is drawn one by one and through FillTriangles(),
+ * a debug overlay of lines one by one and through DrawLines(), a rotated
+ * and zoomed texture sampled per pixel and by rows with SampleBLRow(), and a
+ * full screen layer rotated with DrawRotatedSprite(), immediate and deferred.
+ *
+ * No window is opened, so it runs anywhere the engine compiles.
+ *
+ * Linux:
+ *     g++ -O2 -std=c++17 -o RasterBench bench/RasterBench.cpp \
+ *         -lX11 -lGL -lpthread -lpng -lstdc++fs
+ *     ./RasterBench [frames] [max threads]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+
+#define OLC_PGE_APPLICATION
+#include "../pge/olcPixelGameEngine.h"
+
+namespace
+{
+	struct Shape
+	{
+		int type;
+		int32_t v[6];
+		uint32_t scale;
+		uint8_t flip;
+		olc::Pixel p;
+		olc::Pixel::Mode mode;
+		float fBlend;
+	};
+
+	std::vector<Shape> makeScene(int32_t w, int32_t h, uint32_t nShapes, std::mt19937& rng)
+	{
+		std::uniform_int_distribution<int32_t> X(-64, w), Y(-64, h), S(4, 96), C(0, 255), T(0, 9);
+		std::vector<Shape> vShapes;
+		for (uint32_t i = 0; i < nShapes; i++)
+		{
+			Shape s;
+			s.type = i % 4;
+			s.scale = 1 + (i % 7 == 0);
+			s.flip = uint8_t(i & 3);
+			s.p = olc::Pixel(C(rng), C(rng), C(rng), C(rng));
+			int t = T(rng);
+			s.mode = t < 6 ? olc::Pixel::NORMAL : (t < 8 ? olc::Pixel::MASK : olc::Pixel::ALPHA);
+			s.fBlend = 0.25f + float(C(rng)) / 340.0f;
+			int32_t x = X(rng), y = Y(rng);
+			s.v[0] = x; s.v[1] = y;
+			s.v[2] = x + S(rng) - 48; s.v[3] = y + S(rng);
+			s.v[4] = x + S(rng); s.v[5] = y + S(rng) - 48;
+			if (s.type == 0) { s.v[2] = S(rng); s.v[3] = S(rng); }
+			if (s.type == 1) s.v[2] = S(rng) / 2;
+			vShapes.push_back(s);
+		}
+		return vShapes;
+	}
+
+	void drawScene(olc::PixelGameEngine& pge, const std::vector<Shape>& vShapes, olc::Sprite* spr)
+	{
+		pge.Clear(olc::Pixel(16, 24, 32));
+		for (const auto& s : vShapes)
+		{
+			pge.SetPixelMode(s.mode);
+			pge.SetPixelBlend(s.fBlend);
+			switch (s.type)
+			{
+			case 0: pge.FillRect(s.v[0], s.v[1], s.v[2], s.v[3], s.p); break;
+			case 1: pge.FillCircle(s.v[0], s.v[1], s.v[2], s.p); break;
+			case 2: pge.FillTriangle(s.v[0], s.v[1], s.v[2], s.v[3], s.v[4], s.v[5], s.p); break;
+			case 3: pge.DrawSprite(s.v[0], s.v[1], spr, s.scale, s.flip); break;
+			}
+		}
+		pge.SetPixelMode(olc::Pixel::NORMAL);
+		pge.FlushDeferred();
+	}
+
+	template<typename F>
+	double timeMs(F&& f)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		f();
+		auto t1 = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(t1 - t0).count();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+	uint32_t nMaxThreads = argc > 2 ? uint32_t(std::max(1, std::atoi(argv[2]))) : std::max(8u, std::thread::hardware_concurrency());
+
+	const int32_t w = 1280, h = 720;
+	std::mt19937 rng(1234);
+	std::vector<Shape> vShapes = makeScene(w, h, 4000, rng);
+
+	olc::Sprite spr(48, 48);
+	for (int32_t y = 0; y < spr.height; y++)
+		for (int32_t x = 0; x < spr.width; x++)
+			spr.SetPixel(x, y, olc::Pixel(uint8_t(x * 5), uint8_t(y * 5), uint8_t(x ^ y), ((x / 8 + y / 8) % 3) ? 255 : 0));
+
+	olc::PixelGameEngine pge;
+	olc::Sprite target(w, h), reference(w, h);
+
+	pge.SetDrawTarget(&reference);
+	drawScene(pge, vShapes, &spr);
+	double tImmediate = 1e30;
+	for (int f = 0; f < frames; f++)
+		tImmediate = std::min(tImmediate, timeMs([&] { drawScene(pge, vShapes, &spr); }));
+
+	std::cout << "Scene: " << vShapes.size() << " shapes into " << w << "x" << h
+		<< ", " << std::thread::hardware_concurrency() << " hardware threads\n\n";
+	std::cout << std::left << std::setw(24) << "immediate" << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(10) << tImmediate << " ms/frame\n";
+
+	bool bValid = true;
+	for (uint32_t nThreads = 1; nThreads <= nMaxThreads; nThreads *= 2)
+	{
+		pge.SetDrawTarget(&target);
+		pge.SetDeferredDrawing(true, nThreads);
+		drawScene(pge, vShapes, &spr);
+		bool bSame = std::equal(target.pColData.begin(), target.pColData.end(), reference.pColData.begin(),
+			[](const olc::Pixel& a, const olc::Pixel& b) { return a.n == b.n; });
+		bValid &= bSame;
+
+		double t = 1e30;
+		for (int f = 0; f < frames; f++)
+			t = std::min(t, timeMs([&] { drawScene(pge, vShapes, &spr); }));
+		pge.SetDeferredDrawing(false);
+
+		std::cout << std::left << std::setw(24) << ("deferred, " + std::to_string(nThreads) + " thread(s)")
+			<< std::right << std::setw(10) << t << " ms/frame" << std::setw(8) << tImmediate / t << "x"
+			<< (bSame ? "" : "  MISMATCH") << "\n";
+	}
+
+	// Particles, many small triangles one by one and as one batch
+	{
+		std::uniform_int_distribution<int32_t> X(0, w), Y(0, h), D(-6, 6), C(0, 255);
+		std::vector<olc::vi2d> vVertices;
+		std::vector<olc::Pixel> vColours;
+		for (int i = 0; i < 50000; i++)
+		{
+			olc::vi2d c = { X(rng), Y(rng) };
+			vVertices.push_back(c + olc::vi2d(D(rng), D(rng)));
+			vVertices.push_back(c + olc::vi2d(D(rng), D(rng)));
+			vVertices.push_back(c + olc::vi2d(D(rng), D(rng)));
+			vColours.push_back(olc::Pixel(C(rng), C(rng), C(rng)));
+		}
+
+		double tSingle = 1e30, tBatch = 1e30;
+		for (int f = 0; f < frames; f++)
+		{
+			pge.SetDrawTarget(&reference);
+			tSingle = std::min(tSingle, timeMs([&]
+			{
+				for (size_t i = 0; i < vColours.size(); i++)
+					pge.FillTriangle(vVertices[i * 3], vVertices[i * 3 + 1], vVertices[i * 3 + 2], vColours[i]);
+			}));
+			pge.SetDrawTarget(&target);
+			tBatch = std::min(tBatch, timeMs([&] { pge.FillTriangles(vVertices, vColours); }));
+		}
+		bool bSame = std::equal(target.pColData.begin(), target.pColData.end(), reference.pColData.begin(),
+			[](const olc::Pixel& a, const olc::Pixel& b) { return a.n == b.n; });
+		bValid &= bSame;
+
+		std::cout << "\n" << vColours.size() << " particles\n";
+		std::cout << std::left << std::setw(24) << "FillTriangle" << std::right << std::setw(10) << tSingle << " ms/frame\n";
+		std::cout << std::left << std::setw(24) << "FillTriangles" << std::right << std::setw(10) << tBatch << " ms/frame"
+			<< std::setw(8) << tSingle / tBatch << "x" << (bSame ? "" : "  MISMATCH") << "\n";
+	}
+
+	// Debug overlay lines, a third of them running far off the target
+	{
+		std::uniform_int_distribution<int32_t> X(0, w), Y(0, h), F(-20000, 20000), C(0, 255);
+		std::vector<olc::vi2d> vPoints;
+		for (int i = 0; i < 20000; i++)
+		{
+			vPoints.push_back({ X(rng), Y(rng) });
+			if (i % 3 == 0) vPoints.push_back({ F(rng), F(rng) });
+			else if (i % 3 == 1) vPoints.push_back({ X(rng), vPoints.back().y });
+			else vPoints.push_back({ X(rng), Y(rng) });
+		}
+
+		double tSingle = 1e30, tBatch = 1e30;
+		for (int f = 0; f < frames; f++)
+		{
+			pge.SetDrawTarget(&reference);
+			tSingle = std::min(tSingle, timeMs([&]
+			{
+				for (size_t i = 0; i < vPoints.size(); i += 2)
+					pge.DrawLine(vPoints[i], vPoints[i + 1], olc::GREEN, 0xF0F0F0F0);
+			}));
+			pge.SetDrawTarget(&target);
+			tBatch = std::min(tBatch, timeMs([&] { pge.DrawLines(vPoints, olc::GREEN, 0xF0F0F0F0); }));
+		}
+		bool bSame = std::equal(target.pColData.begin(), target.pColData.end(), reference.pColData.begin(),
+			[](const olc::Pixel& a, const olc::Pixel& b) { return a.n == b.n; });
+		bValid &= bSame;
+
+		std::cout << "\n" << vPoints.size() / 2 << " lines\n";
+		std::cout << std::left << std::setw(24) << "DrawLine" << std::right << std::setw(10) << tSingle << " ms/frame\n";
+		std::cout << std::left << std::setw(24) << "DrawLines" << std::right << std::setw(10) << tBatch << " ms/frame"
+			<< std::setw(8) << tSingle / tBatch << "x" << (bSame ? "" : "  MISMATCH") << "\n";
+	}
+
+	// Rotozoom, bilinear sampling per pixel against whole rows
+	{
+		olc::Sprite tex(512, 512);
+		for (int32_t y = 0; y < tex.height; y++)
+			for (int32_t x = 0; x < tex.width; x++)
+				tex.SetPixel(x, y, olc::Pixel(uint8_t(x), uint8_t(y), uint8_t((x / 32 + y / 32) * 40), uint8_t(255 - ((x ^ y) & 63))));
+
+		const float fAngle = 0.3f, fZoom = 1.7f;
+		const olc::vf2d vDx = olc::vf2d(std::cos(fAngle), std::sin(fAngle)) / (fZoom * tex.width);
+		const olc::vf2d vDy = olc::vf2d(-std::sin(fAngle), std::cos(fAngle)) / (fZoom * tex.height);
+
+		double tSingle = 1e30, tRow = 1e30;
+		for (int f = 0; f < frames; f++)
+		{
+			tSingle = std::min(tSingle, timeMs([&]
+			{
+				for (int32_t y = 0; y < h; y++)
+					for (int32_t x = 0; x < w; x++)
+					{
+						olc::vf2d uv = vDx * float(x) + vDy * float(y);
+						reference.pColData[size_t(y) * w + x] = tex.SampleBL(uv.x, uv.y);
+					}
+			}));
+			tRow = std::min(tRow, timeMs([&]
+			{
+				for (int32_t y = 0; y < h; y++)
+					tex.SampleBLRow(target.pColData.data() + size_t(y) * w, w, vDy * float(y), vDx);
+			}));
+		}
+
+		// The row sampler rounds its weights, so only closeness is checked, and
+		// only inside the texture where SampleBL() is defined
+		int nMaxDiff = 0;
+		for (int32_t y = 0; y < h; y++)
+			for (int32_t x = 0; x < w; x++)
+			{
+				olc::vf2d uv = vDx * float(x) + vDy * float(y);
+				if (uv.x < 0.5f / tex.width || uv.x > 1.0f - 0.5f / tex.width ||
+					uv.y < 0.5f / tex.height || uv.y > 1.0f - 0.5f / tex.height) continue;
+				const olc::Pixel a = reference.pColData[size_t(y) * w + x], b = target.pColData[size_t(y) * w + x];
+				for (int c = 0; c < 32; c += 8)
+					nMaxDiff = std::max(nMaxDiff, std::abs(int((a.n >> c) & 0xFF) - int((b.n >> c) & 0xFF)));
+			}
+		bValid &= nMaxDiff <= 2;
+
+		std::cout << "\n" << w << "x" << h << " bilinear rotozoom\n";
+		std::cout << std::left << std::setw(24) << "SampleBL" << std::right << std::setw(10) << tSingle << " ms/frame\n";
+		std::cout << std::left << std::setw(24) << "SampleBLRow" << std::right << std::setw(10) << tRow << " ms/frame"
+			<< std::setw(8) << tSingle / tRow << "x" << (nMaxDiff <= 2 ? "" : "  MISMATCH") << "\n";
+	}
+
+	// Full screen layer rotated about the centre, nearest and bilinear
+	{
+		olc::Sprite layer(w, h);
+		for (int32_t y = 0; y < h; y++)
+			for (int32_t x = 0; x < w; x++)
+				layer.SetPixel(x, y, olc::Pixel(uint8_t(x), uint8_t(y), uint8_t((x / 40 + y / 40) * 30), 255));
+
+		std::cout << "\n" << w << "x" << h << " layer rotation\n";
+		for (int nFilter = 0; nFilter < 2; nFilter++)
+		{
+			auto drawRotated = [&]
+			{
+				pge.Clear(olc::BLACK);
+				pge.DrawRotatedSprite({ w * 0.5f, h * 0.5f }, &layer, 0.4f, { w * 0.5f, h * 0.5f }, { 1.1f, 1.1f }, nFilter != 0);
+				pge.FlushDeferred();
+			};
+
+			pge.SetDrawTarget(&reference);
+			double tSingle = 1e30;
+			for (int f = 0; f < frames; f++)
+				tSingle = std::min(tSingle, timeMs(drawRotated));
+
+			pge.SetDrawTarget(&target);
+			pge.SetDeferredDrawing(true, nMaxThreads);
+			double tDeferred = 1e30;
+			for (int f = 0; f < frames; f++)
+				tDeferred = std::min(tDeferred, timeMs(drawRotated));
+			pge.SetDeferredDrawing(false);
+
+			bool bSame = std::equal(target.pColData.begin(), target.pColData.end(), reference.pColData.begin(),
+				[](const olc::Pixel& a, const olc::Pixel& b) { return a.n == b.n; });
+			bValid &= bSame;
+
+			const std::string sName = nFilter ? "bilinear" : "nearest";
+			std::cout << std::left << std::setw(24) << sName << std::right << std::setw(10) << tSingle << " ms/frame\n";
+			std::cout << std::left << std::setw(24) << (sName + ", " + std::to_string(nMaxThreads) + " thread(s)") << std::right
+				<< std::setw(10) << tDeferred << " ms/frame" << std::setw(8) << tSingle / tDeferred << "x" << (bSame ? "" : "  MISMATCH") << "\n";
+		}
+	}
+
+	std::cout << (bValid ? "\nAll frames match their reference\n" : "\nERROR: frames differ\n");
+	return bValid ? 0 : 1;
+}
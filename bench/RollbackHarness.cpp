@@ -0,0 +1,387 @@
+/**
+ * Rollback test harness
+ *
+ * Runs two instances of a small deterministic game, one per thread, that
+ * exchange their inputs over UDP on the loopback interface with an added
+ * delay and jitter. Each instance predicts the other's input by repeating
+ * the last one it got, and when a real input turns out different it rewinds
+ * its GameStateManager to that frame and updates through the frames again.
+ * An instance stalls rather than run further ahead of the other than the
+ * rollback window allows.
+ *
+ * At the end every frame of both instances must match a run that knew all
+ * the inputs from the start, which the harness checks frame by frame.
+ *
+ * Linux:
+ *     g++ -O2 -std=c++17 -o RollbackHarness bench/RollbackHarness.cpp -lpthread
+ *     ./RollbackHarness [frames] [delay ms] [jitter ms] [window]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <deque>
+#include <cstdlib>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../GameStateSystem.h"
+
+using namespace codesmith::gamestate;
+
+namespace
+{
+	const int64_t FRAME_NS = 16666667;
+	const int32_t PARTICLES = 4096;
+	const int32_t WORLD = 1 << 20;		// Positions in 1/1024 pixel units
+
+	// Input bits of a player
+	const uint8_t LEFT = 1, RIGHT = 2, UP = 4, DOWN = 8, PUSH = 16;
+
+	/**
+	 * Everything the game needs to carry on from one frame to the next.
+	 * Integers only, so both instances compute exactly the same.
+	 */
+	struct World
+	{
+		int32_t px[2], py[2];
+		uint32_t score[2];
+		int32_t x[PARTICLES], y[PARTICLES], vx[PARTICLES], vy[PARTICLES];
+	};
+
+	class PlayState : public GameState
+	{
+	public:
+		PlayState() : GameState(0) {
+			for(int32_t i = 0; i < PARTICLES; i++) {
+				m_world.x[i] = int32_t((uint32_t(i) * 2654435761u) % WORLD);
+				m_world.y[i] = int32_t((uint32_t(i) * 40503u * 977u) % WORLD);
+				m_world.vx[i] = (i % 17) - 8;
+				m_world.vy[i] = (i % 13) - 6;
+			}
+			m_world.px[0] = WORLD / 4; m_world.px[1] = 3 * WORLD / 4;
+			m_world.py[0] = m_world.py[1] = WORLD / 2;
+			m_world.score[0] = m_world.score[1] = 0;
+			setSimulation(m_world);
+		}
+
+		// Inputs of the frame about to update, not part of the simulation
+		void setInputs(uint8_t p0, uint8_t p1) { m_input[0] = p0; m_input[1] = p1; };
+
+		bool update(float fElapsedTime) override {
+			World& w = m_world;
+			for(int p = 0; p < 2; p++) {
+				const uint8_t in = m_input[p];
+				w.px[p] = std::min(WORLD - 1, std::max(0, w.px[p] + ((in & RIGHT) ? 4096 : 0) - ((in & LEFT) ? 4096 : 0)));
+				w.py[p] = std::min(WORLD - 1, std::max(0, w.py[p] + ((in & DOWN) ? 4096 : 0) - ((in & UP) ? 4096 : 0)));
+			}
+			for(int32_t i = 0; i < PARTICLES; i++) {
+				for(int p = 0; p < 2; p++) {
+					const int32_t dx = w.x[i] - w.px[p], dy = w.y[i] - w.py[p];
+					if((m_input[p] & PUSH) && std::abs(dx) < 65536 && std::abs(dy) < 65536) {
+						w.vx[i] += dx > 0 ? 3 : -3;
+						w.vy[i] += dy > 0 ? 3 : -3;
+						w.score[p]++;
+					}
+				}
+				w.x[i] += w.vx[i];
+				w.y[i] += w.vy[i];
+				if(w.x[i] < 0 || w.x[i] >= WORLD) { w.vx[i] = -w.vx[i]; w.x[i] += 2 * w.vx[i]; }
+				if(w.y[i] < 0 || w.y[i] >= WORLD) { w.vy[i] = -w.vy[i]; w.y[i] += 2 * w.vy[i]; }
+			}
+			return GameState::update(fElapsedTime);
+		}
+
+		uint64_t hash() const {
+			const uint8_t* p = reinterpret_cast<const uint8_t*>(&m_world);
+			uint64_t h = 14695981039346656037ull;
+			for(std::size_t i = 0; i + 8 <= sizeof(World); i += 8) {
+				uint64_t v;
+				std::memcpy(&v, p + i, 8);
+				h = (h ^ v) * 1099511628211ull;
+			}
+			return h;
+		}
+
+	private:
+		World m_world;
+		uint8_t m_input[2] = { 0, 0 };
+	};
+
+	// What a player presses on a frame, held for a while and then changed
+	uint8_t playerInput(int player, uint32_t frame)
+	{
+		std::mt19937 rng(uint32_t(player * 7919 + (frame / 9) * 104729));
+		return uint8_t(rng() & 31);
+	}
+
+	FrameTime frameTime(uint32_t frame)
+	{
+		FrameTime t;
+		t.frameNs = FRAME_NS;
+		t.sessionNs = int64_t(frame + 1) * FRAME_NS;
+		return t;
+	}
+
+	// Inputs of the last frames, repeated in every packet in case one is lost
+	const uint32_t REDUNDANCY = 8;
+	struct Packet
+	{
+		uint32_t frame;			// Of the last input
+		uint8_t count;
+		uint8_t input[REDUNDANCY];
+	};
+
+	struct Options
+	{
+		uint32_t frames = 2000;
+		int64_t delayNs = 4000000;
+		int64_t jitterNs = 3000000;
+		uint32_t window = 12;
+	};
+
+	struct Stats
+	{
+		uint32_t rollbacks = 0;
+		uint64_t resimulated = 0;
+		uint32_t deepest = 0;
+		uint32_t stalls = 0;
+		double rewindUs = 0.0;
+		double rewindMaxUs = 0.0;
+		double updateUs = 0.0;
+		uint64_t updates = 0;
+		std::vector<uint64_t> hashes;
+	};
+
+	class Peer
+	{
+	public:
+		Peer(int player, int socket, const Options& options) :
+			m_player(player), m_socket(socket), m_options(options),
+			m_remote(options.frames, -1), m_used(options.frames, 0),
+			m_rng(uint32_t(player + 1)) {
+			m_state = std::make_shared<PlayState>();
+			m_manager.addState(m_state, true);
+			m_manager.setRollback(options.window);
+			m_stats.hashes.assign(options.frames, 0);
+		}
+
+		void run() {
+			using clock = std::chrono::steady_clock;
+			const uint32_t frames = m_options.frames;
+			auto tick = clock::now();
+			while(true) {
+				pump();
+				if(m_wrong < m_next) correct();
+				if(m_next == frames) {
+					if(m_confirmed + 1 == int64_t(frames) && m_outbox.empty()) break;
+					wait(1);
+					continue;
+				}
+				// The frame after the last confirmed one has to stay within reach
+				if(int64_t(m_next) - (m_confirmed + 1) >= int64_t(m_options.window) - 1) {
+					m_stats.stalls++;
+					wait(1);
+					continue;
+				}
+				if(clock::now() < tick) { wait(0); continue; }
+				tick += std::chrono::milliseconds(1);
+
+				m_local.push_back(playerInput(m_player, m_next));
+				send(m_next);
+				simulate(m_next);
+				m_next++;
+			}
+		}
+
+		const Stats& stats() const { return m_stats; };
+
+	private:
+		// Updates one frame with the remote input as known or as guessed
+		void simulate(uint32_t frame) {
+			uint8_t remote = 0;
+			if(m_remote[frame] >= 0) remote = uint8_t(m_remote[frame]);
+			else if(m_confirmed >= 0) remote = uint8_t(m_remote[std::size_t(m_confirmed)]);
+			m_used[frame] = remote;
+			const uint8_t local = m_local[frame];
+			m_state->setInputs(m_player == 0 ? local : remote, m_player == 0 ? remote : local);
+			auto t0 = std::chrono::steady_clock::now();
+			m_manager.update(frameTime(frame));
+			auto t1 = std::chrono::steady_clock::now();
+			m_stats.updateUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+			m_stats.updates++;
+			m_stats.hashes[frame] = m_state->hash();
+		}
+
+		// Goes back to the first frame guessed wrong and updates up to now again
+		void correct() {
+			const uint32_t depth = m_next - m_wrong;
+			auto t0 = std::chrono::steady_clock::now();
+			if(!m_manager.rewind(depth)) {
+				std::cerr << "peer " << m_player << ": cannot rewind " << depth << " frames\n";
+				std::exit(1);
+			}
+			auto t1 = std::chrono::steady_clock::now();
+			const double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+			m_stats.rewindUs += us;
+			m_stats.rewindMaxUs = std::max(m_stats.rewindMaxUs, us);
+			m_stats.rollbacks++;
+			m_stats.deepest = std::max(m_stats.deepest, depth);
+			for(uint32_t f = m_wrong; f < m_next; f++) {
+				simulate(f);
+				m_stats.resimulated++;
+			}
+			m_wrong = UINT32_MAX;
+		}
+
+		// Queues the latest inputs, to leave once the delay has passed
+		void send(uint32_t frame) {
+			Packet packet;
+			packet.frame = frame;
+			packet.count = uint8_t(std::min(frame + 1, REDUNDANCY));
+			for(uint32_t i = 0; i < packet.count; i++) {
+				packet.input[i] = m_local[frame + 1 - packet.count + i];
+			}
+			std::uniform_int_distribution<int64_t> jitter(0, m_options.jitterNs);
+			const int64_t ns = m_options.delayNs + jitter(m_rng);
+			auto due = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+			// Later packets never overtake earlier ones, as on one connection
+			if(!m_outbox.empty()) due = std::max(due, m_outbox.back().first);
+			m_outbox.emplace_back(due, packet);
+		}
+
+		void pump() {
+			const auto now = std::chrono::steady_clock::now();
+			while(!m_outbox.empty() && m_outbox.front().first <= now) {
+				const Packet& packet = m_outbox.front().second;
+				::send(m_socket, &packet, sizeof(packet), 0);
+				m_outbox.pop_front();
+			}
+			Packet packet;
+			while(::recv(m_socket, &packet, sizeof(packet), MSG_DONTWAIT) == ssize_t(sizeof(packet))) {
+				if(packet.count > REDUNDANCY || packet.frame >= m_options.frames || packet.count > packet.frame + 1) continue;
+				for(uint32_t i = 0; i < packet.count; i++) {
+					const uint32_t frame = packet.frame + 1 - packet.count + i;
+					if(m_remote[frame] >= 0) continue;
+					m_remote[frame] = packet.input[i];
+					if(frame < m_next && m_used[frame] != packet.input[i]) m_wrong = std::min(m_wrong, frame);
+				}
+				while(m_confirmed + 1 < int64_t(m_options.frames) && m_remote[std::size_t(m_confirmed + 1)] >= 0) {
+					m_confirmed++;
+				}
+			}
+		}
+
+		void wait(int ms) {
+			pollfd fd = { m_socket, POLLIN, 0 };
+			::poll(&fd, 1, ms);
+		}
+
+		int m_player;
+		int m_socket;
+		Options m_options;
+		GameStateManager m_manager;
+		std::shared_ptr<PlayState> m_state;
+
+		uint32_t m_next = 0;					// Frame to update next
+		uint32_t m_wrong = UINT32_MAX;			// First frame updated with a wrong guess
+		int64_t m_confirmed = -1;				// Remote inputs known up to here
+		std::vector<uint8_t> m_local;
+		std::vector<int16_t> m_remote;			// -1 until it arrives
+		std::vector<uint8_t> m_used;			// Remote input each frame was updated with
+		std::deque<std::pair<std::chrono::steady_clock::time_point, Packet>> m_outbox;
+		std::mt19937 m_rng;
+		Stats m_stats;
+	};
+
+	int openSocket(uint16_t& port)
+	{
+		int s = ::socket(AF_INET, SOCK_DGRAM, 0);
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t len = sizeof(addr);
+		if(s < 0 || ::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+			::getsockname(s, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+			return -1;
+		}
+		port = ntohs(addr.sin_port);
+		return s;
+	}
+
+	bool connectSocket(int s, uint16_t port)
+	{
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		return ::connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if(argc > 1) options.frames = uint32_t(std::max(1, std::atoi(argv[1])));
+	if(argc > 2) options.delayNs = int64_t(std::max(0.0, std::atof(argv[2])) * 1e6);
+	if(argc > 3) options.jitterNs = int64_t(std::max(0.0, std::atof(argv[3])) * 1e6);
+	if(argc > 4) options.window = uint32_t(std::max(2, std::atoi(argv[4])));
+
+	// The run that knows every input, to compare the peers against
+	std::vector<uint64_t> reference(options.frames);
+	{
+		GameStateManager manager;
+		auto state = std::make_shared<PlayState>();
+		manager.addState(state, true);
+		for(uint32_t f = 0; f < options.frames; f++) {
+			state->setInputs(playerInput(0, f), playerInput(1, f));
+			manager.update(frameTime(f));
+			reference[f] = state->hash();
+		}
+	}
+
+	uint16_t port[2];
+	int sockets[2] = { openSocket(port[0]), openSocket(port[1]) };
+	if(sockets[0] < 0 || sockets[1] < 0 || !connectSocket(sockets[0], port[1]) || !connectSocket(sockets[1], port[0])) {
+		std::cerr << "No loopback sockets\n";
+		return 1;
+	}
+	std::unique_ptr<Peer> peers[2] = {
+		std::make_unique<Peer>(0, sockets[0], options),
+		std::make_unique<Peer>(1, sockets[1], options) };
+	std::thread threads[2] = {
+		std::thread([&] { peers[0]->run(); }),
+		std::thread([&] { peers[1]->run(); }) };
+	threads[0].join();
+	threads[1].join();
+	::close(sockets[0]);
+	::close(sockets[1]);
+
+	std::cout << "\n2 peers over UDP loopback, " << options.frames << " frames at 1 ms, delay "
+		<< options.delayNs / 1e6 << " ms + up to " << options.jitterNs / 1e6 << " ms, window "
+		<< options.window << ", " << sizeof(World) / 1024 << " KB simulation\n\n" << std::fixed << std::setprecision(1);
+	std::cout << "peer  rollbacks  resimulated  deepest  stalls  rewind us mean/max  update us\n";
+	bool bSame = true;
+	for(int p = 0; p < 2; p++) {
+		const Stats& s = peers[p]->stats();
+		std::cout << std::setw(4) << p << std::setw(11) << s.rollbacks << std::setw(13) << s.resimulated
+			<< std::setw(9) << s.deepest << std::setw(8) << s.stalls
+			<< std::setw(12) << (s.rollbacks ? s.rewindUs / s.rollbacks : 0.0) << " /" << std::setw(6) << s.rewindMaxUs
+			<< std::setw(11) << (s.updates ? s.updateUs / s.updates : 0.0) << "\n";
+		for(uint32_t f = 0; f < options.frames; f++) {
+			if(s.hashes[f] != reference[f]) {
+				std::cout << "peer " << p << " differs from the reference on frame " << f << "\n";
+				bSame = false;
+				break;
+			}
+		}
+	}
+	std::cout << "\nEvery frame matches the reference: " << (bSame ? "yes" : "NO") << "\n";
+	return bSame ? 0 : 1;
+}
@@ -345,6 +345,10 @@ int main()
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <deque>
 #pragma endregion
 
 #define PGE_VER 215
@@ -385,6 +389,12 @@ int main()
 
 #define UNUSED(x) (void)(x)
 
+// SSE2 is part of every x86-64 target, the software samplers use it if present
+#if !defined(OLC_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define OLC_SIMD_SSE2
+	#include <emmintrin.h>
+#endif
+
 // O------------------------------------------------------------------------------O
 // | PLATFORM SELECTION CODE, Thanks slavka!                                      |
 // O------------------------------------------------------------------------------O
@@ -462,6 +472,20 @@ int main()
 	#undef _WINSOCKAPI_
 #endif
 
+#if !defined(_WIN32)
+	// Memory mapped .pgespr files
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+	// olc::AssetWatcher
+	#include <sys/inotify.h>
+	#include <poll.h>
+#endif
+
 #if defined(OLC_PLATFORM_X11)
 	namespace X11
 	{
@@ -571,6 +595,15 @@ namespace olc
 		bool bHeld = false;		// Set true for all frames between pressed and released events
 	};
 
+	// A key or mouse button that went down or up during the frame
+	struct InputEvent
+	{
+		enum class Device : uint8_t { KEYBOARD, MOUSE };
+		Device device = Device::KEYBOARD;
+		uint32_t nCode = 0;		// olc::Key, or the mouse button
+		bool bPressed = false;
+	};
+
 
 
 
@@ -652,12 +685,71 @@ namespace olc
 	
 
 
+	// O------------------------------------------------------------------------------O
+	// | olc::ThreadPool - A small fixed size pool of worker threads                  |
+	// O------------------------------------------------------------------------------O
+	class ThreadPool
+	{
+	public:
+		// nThreads = 0 uses one worker per hardware thread
+		ThreadPool(uint32_t nThreads = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+	public:
+		// Queues a job to be executed by one of the workers
+		void Enqueue(std::function<void()> job);
+		// Blocks until every queued job has completed
+		void Wait();
+		// Calls func(i) for all i in [0, nCount), the calling thread helps out
+		// and the call returns when all indices have been processed
+		void ParallelFor(uint32_t nCount, const std::function<void(uint32_t)>& func);
+		uint32_t Size() const;
+
+	private:
+		void WorkerThread();
+		std::vector<std::thread> vWorkers;
+		std::queue<std::function<void()>> qJobs;
+		std::mutex mtxJobs;
+		std::condition_variable cvJob;
+		std::condition_variable cvIdle;
+		uint32_t nBusy = 0;
+		bool bStop = false;
+	};
+
+
+	// O------------------------------------------------------------------------------O
+	// | olc::LZCodec - Built-in LZ77 byte codec, no external dependencies            |
+	// O------------------------------------------------------------------------------O
+	// Uses the LZ4 block layout, so it is fast to decode and streams written
+	// by it can be inspected with standard tools. Decoding is bounds checked
+	// and writes straight into the caller supplied destination.
+	struct LZCodec
+	{
+		// Worst case size of compressed output for nSize input bytes
+		static size_t Bound(size_t nSize);
+		// Returns number of bytes written into dst, 0 if it did not fit
+		static size_t Compress(const uint8_t* src, size_t nSrcSize, uint8_t* dst, size_t nDstCapacity);
+		// Decodes exactly nDstSize bytes into dst, false if the stream is malformed
+		static bool Decompress(const uint8_t* src, size_t nSrcSize, uint8_t* dst, size_t nDstSize);
+	};
+
+
 	// O------------------------------------------------------------------------------O
 	// | olc::ResourcePack - A virtual scrambled filesystem to pack your assets into  |
 	// O------------------------------------------------------------------------------O
+	enum class ResourceCodec : uint32_t
+	{
+		RAW = 0,
+		LZ = 1,
+	};
+
 	struct ResourceBuffer : public std::streambuf
 	{
 		ResourceBuffer(std::ifstream& ifs, uint32_t offset, uint32_t size);
+		ResourceBuffer(std::ifstream& ifs, uint32_t offset, uint32_t size, uint32_t stored, ResourceCodec codec);
+		ResourceBuffer(std::vector<char>&& data);
 		std::vector<char> vMemory;
 	};
 
@@ -666,20 +758,40 @@ namespace olc
 	public:
 		ResourcePack();
 		~ResourcePack();
-		bool AddFile(const std::string& sFile);
+		// Entries added with ResourceCodec::LZ are compressed when the pack is
+		// saved, unless compression would not make them any smaller
+		bool AddFile(const std::string& sFile, ResourceCodec codec = ResourceCodec::RAW);
 		bool LoadPack(const std::string& sFile, const std::string& sKey);
 		bool SavePack(const std::string& sFile, const std::string& sKey);
 		ResourceBuffer GetFileBuffer(const std::string& sFile);
+		// Reads the listed entries in file order and decodes them in parallel.
+		// The next GetFileBuffer() of a preloaded entry hands over the decoded
+		// memory without touching the disk. Returns number of entries preloaded.
+		uint32_t Preload(const std::vector<std::string>& vFiles, uint32_t nThreads = 0);
+		uint32_t Preload(const std::vector<std::string>& vFiles, ThreadPool& pool);
 		bool Loaded();
+		// Note: GetFileBuffer() and Preload() may be called from several threads
+		// at once, file access is serialised internally
 	private:
-		struct sResourceFile { uint32_t nSize; uint32_t nOffset; };
+		struct sResourceFile
+		{
+			uint32_t nSize = 0;
+			uint32_t nOffset = 0;
+			uint32_t nStored = 0;
+			ResourceCodec nCodec = ResourceCodec::RAW;
+		};
 		std::map<std::string, sResourceFile> mapFiles;
+		std::map<std::string, std::vector<char>> mapPreloaded;
+		std::mutex mtxPack;
 		std::ifstream baseFile;
 		std::vector<char> scramble(const std::vector<char>& data, const std::string& key);
 		std::string makeposix(const std::string& path);
 	};
 
 
+	// Image loaders are shared by all sprites through Sprite::loader and must be
+	// safe to call concurrently for different sprites, as Renderable::LoadBatch()
+	// decodes on several threads at once. Keep all decoder state local to a call.
 	class ImageLoader
 	{
 	public:
@@ -690,22 +802,87 @@ namespace olc
 	};
 
 
+	// O------------------------------------------------------------------------------O
+	// | olc::PixelBuffer - Contiguous pixel storage behind olc::Sprite               |
+	// O------------------------------------------------------------------------------O
+	// Looks like the std::vector it replaces, but can also hand out storage without
+	// filling it first, or take over memory that a decoder allocated, so loading an
+	// image costs one allocation and no copy.
+	class PixelBuffer
+	{
+	public:
+		// Called once with the adopted pointer when the buffer is done with it
+		using ReleaseFunc = std::function<void(olc::Pixel*)>;
+
+		PixelBuffer() = default;
+		PixelBuffer(const olc::PixelBuffer&) = delete;
+		PixelBuffer(olc::PixelBuffer&& other) noexcept;
+		PixelBuffer& operator=(const olc::PixelBuffer&) = delete;
+		PixelBuffer& operator=(olc::PixelBuffer&& other) noexcept;
+		~PixelBuffer();
+
+	public:
+		// std::vector like, new pixels take the default or given colour
+		void resize(size_t nPixels);
+		void resize(size_t nPixels, const olc::Pixel& p);
+		void clear();
+		// Discards contents, the new storage is left uninitialised
+		void allocate_uninitialised(size_t nPixels);
+		// Takes ownership of nPixels at pNewData, freed with funcNewRelease, or
+		// std::free() if none given
+		void adopt(olc::Pixel* pNewData, size_t nPixels, ReleaseFunc funcNewRelease = nullptr);
+
+		size_t size() const { return nSize; }
+		bool empty() const { return nSize == 0; }
+		olc::Pixel* data() { return pData; }
+		const olc::Pixel* data() const { return pData; }
+		olc::Pixel& operator[](size_t i) { return pData[i]; }
+		const olc::Pixel& operator[](size_t i) const { return pData[i]; }
+		olc::Pixel* begin() { return pData; }
+		olc::Pixel* end() { return pData + nSize; }
+		const olc::Pixel* begin() const { return pData; }
+		const olc::Pixel* end() const { return pData + nSize; }
+
+	private:
+		olc::Pixel* pData = nullptr;
+		size_t nSize = 0;
+		ReleaseFunc funcRelease = nullptr;
+	};
+
 	// O------------------------------------------------------------------------------O
 	// | olc::Sprite - An image represented by a 2D array of olc::Pixel               |
 	// O------------------------------------------------------------------------------O
 	class Sprite
 	{
+	public:
+		// How texels are stored. Masks, heightmaps and light buffers need fewer
+		// channels than RGBA8 and decals upload them in the matching GL format.
+		// Read as olc::Pixel the missing channels are 0 and alpha 255, as GL
+		// samples them; R32F is clamped to 0..1. GetPixel() and SetPixel()
+		// convert, but draw targets and files are always RGBA8.
+		enum class Format : uint8_t { RGBA8, R8, RG8, R32F };
+		// How texels are ordered. LINEAR is row by row. TILED keeps each 8x8 block
+		// together, padding the edges to whole tiles, so rotations, column walks
+		// and neighbourhood filters stay in cache. Draw targets, layers, files and
+		// the atlas want LINEAR; decals upload a linear copy.
+		enum class Layout : uint8_t { LINEAR, TILED };
+
 	public:
 		Sprite();
 		Sprite(const std::string& sImageFile, olc::ResourcePack* pack = nullptr);
 		Sprite(int32_t w, int32_t h);
+		Sprite(int32_t w, int32_t h, olc::Sprite::Format format);
 		Sprite(const olc::Sprite&) = delete;
 		~Sprite();
 
 	public:
 		olc::rcode LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack = nullptr);
 		olc::rcode LoadFromPGESprFile(const std::string& sImageFile, olc::ResourcePack* pack = nullptr);
-		olc::rcode SaveToPGESprFile(const std::string& sImageFile);
+		olc::rcode SaveToPGESprFile(const std::string& sImageFile, olc::ResourceCodec codec = olc::ResourceCodec::RAW);
+		// Images loaded from disk are kept as .pgespr files in sDirectory, keyed by
+		// source path and revalidated against its size, mtime and content hash, so
+		// later runs skip decoding. Empty turns it off (default), set before loading.
+		static void SetFileCache(const std::string& sDirectory, olc::ResourceCodec codec = olc::ResourceCodec::RAW);
 
 	public:
 		int32_t width = 0;
@@ -721,13 +898,50 @@ namespace olc
 		bool  SetPixel(const olc::vi2d& a, Pixel p);
 		Pixel Sample(float x, float y) const;
 		Pixel SampleBL(float u, float v) const;
+		// Fills nCount pixels with bilinear samples, the first at uv and each next
+		// one duv further along, all in normalised coordinates as SampleBL().
+		// Works in 8 bit fixed point weights, within two steps per channel of
+		// SampleBL(). Outside the sprite NORMAL clamps to the edge texels and
+		// PERIODIC wraps around.
+		void SampleBLRow(olc::Pixel* pDest, uint32_t nCount, const olc::vf2d& uv, const olc::vf2d& duv) const;
 		Pixel* GetData();
 		olc::Sprite* Duplicate();
 		olc::Sprite* Duplicate(const olc::vi2d& vPos, const olc::vi2d& vSize);
-		std::vector<olc::Pixel> pColData;
+		// Exchanges the images of two sprites, both objects stay where they are
+		void Swap(olc::Sprite& other);
+		olc::PixelBuffer pColData;
 		Mode modeSample = Mode::NORMAL;
 
+	public: // Storage format
+		olc::Sprite::Format GetFormat() const;
+		static uint32_t GetFormatSize(olc::Sprite::Format format);
+		// Texels packed in the sprite's format, rows width * GetFormatSize() bytes
+		uint8_t* GetRawData();
+		const uint8_t* GetRawData() const;
+		// A copy of this sprite in another format
+		olc::Sprite* Convert(olc::Sprite::Format format) const;
+		// Converts nCount texels between formats, the kernel behind Convert()
+		static void ConvertPixels(olc::Sprite::Format formatFrom, const void* pFrom, olc::Sprite::Format formatTo, void* pTo, size_t nCount);
+
+	public: // Storage layout
+		olc::Sprite::Layout GetLayout() const;
+		// Reorders the texels in place, a row of a tile at a time
+		void SetLayout(olc::Sprite::Layout layout);
+		// Index into the raw data of texel (x,y), which must be inside the sprite
+		size_t GetTexelIndex(int32_t x, int32_t y) const
+		{ return layout == Layout::LINEAR ? size_t(y) * size_t(width) + size_t(x) : GetTiledIndex(x, y, (width + 7) >> 3); }
+		static size_t GetTiledIndex(int32_t x, int32_t y, int32_t nTilesX)
+		{ return ((size_t(y >> 3) * size_t(nTilesX) + size_t(x >> 3)) << 6) | size_t((y & 7) << 3) | size_t(x & 7); }
+
 		static std::unique_ptr<olc::ImageLoader> loader;
+
+	private:
+		olc::rcode LoadFromFileCached(const std::string& sImageFile);
+		size_t GetStorageTexels() const;
+		olc::Sprite::Format format = olc::Sprite::Format::RGBA8;
+		olc::Sprite::Layout layout = olc::Sprite::Layout::LINEAR;
+		static std::string sCacheDirectory;
+		static olc::ResourceCodec cacheCodec;
 	};
 
 	// O------------------------------------------------------------------------------O
@@ -770,11 +984,102 @@ namespace olc
 		olc::Decal* Decal() const;
 		olc::Sprite* Sprite() const;
 
+	public:
+		// One image to be loaded by LoadBatch()
+		struct BatchItem
+		{
+			olc::Renderable* target = nullptr;
+			std::string sFile;
+			ResourcePack* pack = nullptr;
+			bool filter = false;
+			bool clamp = true;
+			// Set by LoadBatch()
+			olc::rcode result = olc::rcode::FAIL;
+			float fDecodeTime = 0.0f; // Seconds spent decoding on a worker
+		};
+
+		// Decodes all items concurrently on a thread pool, then creates all the
+		// decals in one pass on the calling thread. Call it from the thread that
+		// owns the graphics context, e.g. OnUserCreate() or OnUserUpdate().
+		// Returns the number of items successfully loaded.
+		static uint32_t LoadBatch(std::vector<BatchItem>& vItems, uint32_t nThreads = 0);
+		static uint32_t LoadBatch(std::vector<BatchItem>& vItems, ThreadPool& pool);
+
 	private:
+		friend class AssetWatcher;
 		std::unique_ptr<olc::Sprite> pSprite = nullptr;
 		std::unique_ptr<olc::Decal> pDecal = nullptr;
 	};
 
+	// O------------------------------------------------------------------------------O
+	// | olc::DecalRegion - A rectangle within a decal, as handed out by olc::Atlas   |
+	// O------------------------------------------------------------------------------O
+	struct DecalRegion
+	{
+		olc::Decal* decal = nullptr;
+		uint32_t nPage = 0;
+		olc::vf2d vPos = { 0.0f, 0.0f };    // Source rectangle in pixels
+		olc::vf2d vSize = { 0.0f, 0.0f };
+		olc::vf2d vUVPos = { 0.0f, 0.0f };  // The same in texture coordinates
+		olc::vf2d vUVSize = { 0.0f, 0.0f };
+	};
+
+	// O------------------------------------------------------------------------------O
+	// | olc::Atlas - Packs many sprites onto a few shared decal pages                |
+	// O------------------------------------------------------------------------------O
+	// Decals drawn one after another from the same page keep one texture bound.
+	// Everything but CreateDecals() is CPU only, so atlases can be built offline.
+	class Atlas
+	{
+	public:
+		Atlas(int32_t nPageSize = 2048, int32_t nPadding = 1);
+
+	public:
+		// Queues a sprite, which must stay alive until the next Pack(). Returns the
+		// index of its region.
+		uint32_t Add(const std::string& sName, const olc::Sprite* spr);
+		// Skyline packs everything queued, tallest first, into the free space of
+		// existing pages before opening new ones. Padding repeats the edge pixels.
+		olc::rcode Pack();
+		// (Re)creates the page decals, call again after packing more sprites
+		void CreateDecals(bool filter = false, bool clamp = true);
+		// Writes <sBaseName>.atlas plus one <sBaseName>_<n>.pgespr per page, and
+		// adds them all to pack if given, ready for ResourcePack::SavePack()
+		olc::rcode Save(const std::string& sBaseName, olc::ResourceCodec codec = olc::ResourceCodec::LZ, olc::ResourcePack* pack = nullptr);
+		olc::rcode Load(const std::string& sBaseName, olc::ResourcePack* pack = nullptr);
+
+	public:
+		const olc::DecalRegion& Region(uint32_t nIndex) const;
+		const olc::DecalRegion* Region(const std::string& sName) const;
+		size_t RegionCount() const;
+		size_t PageCount() const;
+		olc::Sprite* PageSprite(size_t nPage) const;
+		olc::Decal* PageDecal(size_t nPage) const;
+
+	private:
+		struct sSkylineNode { int32_t x, y, w; };
+		struct sPage
+		{
+			std::unique_ptr<olc::Sprite> pSprite;
+			std::unique_ptr<olc::Decal> pDecal;
+			std::vector<sSkylineNode> vSkyline;
+			int32_t nWidth = 0;
+			int32_t nMaxHeight = 0;
+			int32_t nUsedHeight = 0;
+		};
+
+		bool PlaceOnPage(sPage& page, int32_t w, int32_t h, olc::vi2d& vPos) const;
+		void UpdateRegionUVs();
+
+		int32_t nPageSize = 2048;
+		int32_t nPadding = 1;
+		std::vector<sPage> vPages;
+		std::vector<olc::DecalRegion> vRegions;
+		std::vector<std::string> vNames;
+		std::map<std::string, uint32_t> mapRegions;
+		std::vector<std::pair<uint32_t, const olc::Sprite*>> vQueued;
+	};
+
 
 	// O------------------------------------------------------------------------------O
 	// | Auxilliary components internal to engine                                     |
@@ -789,6 +1094,8 @@ namespace olc
 		std::vector<olc::Pixel> tint;
 		olc::DecalMode mode = olc::DecalMode::NORMAL;
 		uint32_t points = 0;
+		// Sort layer, mode and texture, set on layers with decal sorting enabled
+		uint64_t key = 0;
 	};
 
 	struct LayerDesc
@@ -797,6 +1104,7 @@ namespace olc
 		olc::vf2d vScale = { 1, 1 };
 		bool bShow = false;
 		bool bUpdate = false;
+		bool bSortDecals = false;
 		olc::Sprite* pDrawTarget = nullptr;
 		uint32_t nResID = 0;
 		std::vector<DecalInstance> vecDecalInstance;
@@ -804,6 +1112,69 @@ namespace olc
 		std::function<void()> funcHook = nullptr;
 	};
 
+	// O------------------------------------------------------------------------------O
+	// | olc::FramePipeline - Hands finished frames from the update to the render     |
+	// O------------------------------------------------------------------------------O
+	// With PixelGameEngine::SetPipelinedUpdate(true) OnUserUpdate() runs on a thread
+	// of its own. Each frame ends by filling a Packet with the layers and decals it
+	// drew, which the thread owning the graphics context then renders while the
+	// next frame is already being updated. Anything else that must touch the
+	// renderer is passed over with RunOnRenderThread().
+	class FramePipeline
+	{
+	public:
+		struct Packet
+		{
+			std::vector<olc::LayerDesc> vLayers;
+			// Copies of the layers redrawn this frame, pDrawTarget points in here
+			std::vector<std::unique_ptr<olc::Sprite>> vLayerPixels;
+			std::string sWindowTitle;
+		};
+
+	public:
+		// Called on the render thread, nBuffers packets may be in flight at once
+		void Start(uint32_t nBuffers);
+		// Called by the update side after its last packet
+		void Finish();
+		// Called on the render thread once NextPacket() reported done
+		void Stop();
+		bool IsRunning() const;
+		bool IsRenderThread() const;
+
+		// Update side, waits while every packet is queued or being rendered
+		Packet* BeginPacket();
+		void SubmitPacket(Packet* packet);
+
+		// Render side, waits up to nTimeout for a packet. Calls passed over with
+		// RunOnRenderThread() are run in here, but only once no packet is queued,
+		// so they land in the same order relative to frames as they were made.
+		// Returns nullptr on timeout, bDone is set once Finish() was drained.
+		Packet* NextPacket(std::chrono::milliseconds nTimeout, bool& bDone);
+		void ReleasePacket(Packet* packet);
+
+		// Runs f on the render thread and waits for it to complete. Called
+		// directly when not pipelined or when already on the render thread.
+		void RunOnRenderThread(const std::function<void()>& f);
+
+	private:
+		struct Call
+		{
+			const std::function<void()>* func = nullptr;
+			bool bDone = false;
+		};
+
+		std::vector<std::unique_ptr<Packet>> vPackets;
+		std::vector<Packet*> vFree;
+		std::deque<Packet*> qReady;
+		std::deque<Call*> qCalls;
+		std::mutex mux;
+		std::condition_variable cvRender;
+		std::condition_variable cvUpdate;
+		std::thread::id idRenderThread;
+		std::atomic<bool> bRunning = { false };
+		bool bFinished = false;
+	};
+
 	class Renderer
 	{
 	public:
@@ -849,6 +1220,65 @@ namespace olc
 	static std::unique_ptr<Platform> platform;
 	static std::map<size_t, uint8_t> mapKeys;
 
+	// Only exists while PixelGameEngine::SetPipelinedUpdate() is on
+	static std::unique_ptr<FramePipeline> pipeline;
+	inline void RunOnRenderThread(const std::function<void()>& f)
+	{ if (pipeline) pipeline->RunOnRenderThread(f); else f(); }
+
+	// Start to start intervals of the most recent frames, in milliseconds
+	struct FrameStats
+	{
+		uint32_t nFrames = 0;
+		double fTargetMs = 0.0; // 0 when the frame rate is not limited
+		double fMeanMs = 0.0;
+		double fMinMs = 0.0;
+		double fMaxMs = 0.0;
+		double fStdDevMs = 0.0; // Jitter around the mean
+		double fP99Ms = 0.0;
+	};
+
+	// O------------------------------------------------------------------------------O
+	// | olc::SessionLog - Timing and input of every frame, to replay a session       |
+	// O------------------------------------------------------------------------------O
+	// Everything a frame takes from outside the application, as it stood when the
+	// hardware input was scanned
+	struct SessionFrame
+	{
+		int64_t nFrameTimeNs = 0;
+		std::vector<olc::InputEvent> vInput;
+		olc::vi2d vMousePos = { 0, 0 };
+		int32_t nMouseWheelDelta = 0;
+		bool bInputFocus = false;
+		bool bMouseFocus = false;
+	};
+
+	// A binary log of SessionFrames. Each frame is stored as what changed since
+	// the one before, so a frame without input takes a few bytes.
+	class SessionLog
+	{
+	public:
+		olc::rcode OpenWrite(const std::string& sFile, const olc::vi2d& vScreenSize);
+		olc::rcode OpenRead(const std::string& sFile);
+		void Close();
+		bool IsOpen() const;
+		// Size of the screen the session was recorded at
+		const olc::vi2d& GetScreenSize() const;
+		void Write(const SessionFrame& frame);
+		// False at the end of the log
+		bool Read(SessionFrame& frame);
+
+	private:
+		void PutVarint(uint64_t n);
+		bool GetVarint(uint64_t& n);
+		static uint64_t ZigZag(int64_t n) { return (uint64_t(n) << 1) ^ uint64_t(n >> 63); }
+		static int64_t UnZigZag(uint64_t n) { return int64_t(n >> 1) ^ -int64_t(n & 1); }
+
+		std::fstream file;
+		SessionFrame last;
+		olc::vi2d vScreenSize = { 0, 0 };
+		std::vector<uint8_t> vBuffer;
+	};
+
 	// O------------------------------------------------------------------------------O
 	// | olc::PixelGameEngine - The main BASE class for your application              |
 	// O------------------------------------------------------------------------------O
@@ -861,6 +1291,13 @@ namespace olc
 		olc::rcode Construct(int32_t screen_w, int32_t screen_h, int32_t pixel_w, int32_t pixel_h,
 			bool full_screen = false, bool vsync = false, bool cohesion = false);
 		olc::rcode Start();
+		// In place of Start(), runs a recorded session without a window or
+		// graphics, as fast as possible. Every frame gets the timing and input
+		// it was recorded with, and the time its update took goes in vUpdateNs.
+		olc::rcode Replay(const std::string& sFile, std::vector<int64_t>& vUpdateNs);
+		// In place of Start(), runs on the real clock without a window or
+		// graphics until OnUserUpdate() returns false, for tools and benchmarks.
+		olc::rcode StartHeadless();
 
 	public: // User Override Interfaces
 		// Called once on application startup, use to load your resources
@@ -877,6 +1314,9 @@ namespace olc
 		HWButton GetKey(Key k) const;
 		// Get the state of a specific mouse button
 		HWButton GetMouse(uint32_t b) const;
+		// Keys and mouse buttons that went down or up this frame, in the order
+		// they did, the same changes GetKey() and GetMouse() report
+		const std::vector<olc::InputEvent>& GetInputEvents() const;
 		// Get Mouse X coordinate in "pixel" space
 		int32_t GetMouseX() const;
 		// Get Mouse Y coordinate in "pixel" space
@@ -902,12 +1342,44 @@ namespace olc
 		// Resize the primary screen sprite
 		void SetScreenSize(int w, int h);
 		// Specify which Sprite should be the target of drawing functions, use nullptr
-		// to specify the primary screen
+		// to specify the primary screen. Only RGBA8 sprites in the LINEAR layout can
+		// be drawn into, the target stays as it was for any other.
 		void SetDrawTarget(Sprite* target);
 		// Gets the current Frames Per Second
 		uint32_t GetFPS() const;
+		// Caps the frame rate by sleeping off the rest of each frame, then spinning
+		// for the last moment so wake up stays precise. 0 (default) is uncapped.
+		// Has no effect on Emscripten, where the browser paces frames.
+		void SetFrameRateLimit(float fFramesPerSecond);
+		// While idle the engine is paced at this much lower rate, sleeping only.
+		// Keys are sampled once a frame, so keep it high enough for quick taps.
+		void SetIdleFrameRate(float fFramesPerSecond);
+		// Enter or leave idle, e.g. while a pause or menu screen shows
+		void SetIdle(bool bIdle);
+		bool IsIdle() const;
+		// Frame interval statistics over the last 256 frames
+		olc::FrameStats GetFrameStats() const;
+		// Records the timing and input of every frame from the next one on, so
+		// the session can be replayed. Start it in OnUserCreate() to record the
+		// whole session, as a replay starts from there.
+		olc::rcode StartRecording(const std::string& sFile);
+		void StopRecording();
+		// Runs OnUserUpdate() on a thread of its own, overlapping with the
+		// rendering of the previous frame on the thread owning the graphics
+		// context. Layer hooks still run there, during rendering, so must not
+		// read state the update changes. Call before Start(), nBuffers (2 or 3)
+		// is how many frames may be in flight. Not used by custom start ups.
+		void SetPipelinedUpdate(bool bEnable, uint32_t nBuffers = 2);
+		bool IsPipelinedUpdate() const;
 		// Gets last update of elapsed time
 		float GetElapsedTime() const;
+		// As above, exact in nanoseconds from a monotonic clock
+		int64_t GetFrameTimeNs() const;
+		// Sum of all frame times since the engine started, i.e. when this frame began
+		int64_t GetSessionTimeNs() const;
+		double GetSessionTime() const;
+		// Counts frames from 0, the value during the first OnUserUpdate()
+		uint64_t GetFrameIndex() const;
 		// Gets Actual Window size
 		const olc::vi2d& GetWindowSize() const;
 		// Gets pixel scale
@@ -925,6 +1397,11 @@ namespace olc
 		void SetLayerScale(uint8_t layer, float x, float y);
 		void SetLayerTint(uint8_t layer, const olc::Pixel& tint);
 		void SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f);
+		// Draws the decals of a layer in sort key order instead of call order.
+		// Sort layers are drawn back to front, and within one the calls are
+		// grouped by decal mode and texture to save state changes. Calls with
+		// equal keys keep their order.
+		void EnableDecalSorting(uint8_t layer, bool b);
 
 		std::vector<LayerDesc>& GetLayers();
 		uint32_t CreateLayer();
@@ -940,33 +1417,61 @@ namespace olc
 		// Change the blend factor from between 0.0f to 1.0f;
 		void SetPixelBlend(float fBlend);
 
+		// Records Clear, FillRect, FillCircle, FillTriangle, DrawSprite and
+		// DrawPartialSprite instead of drawing them straight away. They are
+		// binned into 64x64 tiles of the draw target and the tiles rasterized
+		// in parallel when the update is done, when anything else draws, when
+		// the draw target changes or on FlushDeferred(). The pixels come out
+		// exactly as if drawn immediately. Source sprites are read at that
+		// point so must not change before, and custom pixel modes are called
+		// from several threads. nThreads = 0 uses every hardware thread.
+		void SetDeferredDrawing(bool bEnable, uint32_t nThreads = 0);
+		bool IsDeferredDrawing() const;
+		// Rasterizes everything recorded so far, call this before accessing the
+		// pixels of the draw target directly
+		void FlushDeferred();
+
 
 
 	public: // DRAWING ROUTINES
-		// Draws a single Pixel
+		// Draws a single Pixel. Overriding it does not change the lines, the
+		// fills and the transformed sprites, which write the draw target
+		// directly without calling it.
 		virtual bool Draw(int32_t x, int32_t y, Pixel p = olc::WHITE);
 		bool Draw(const olc::vi2d& pos, Pixel p = olc::WHITE);
-		// Draws a line from (x1,y1) to (x2,y2)
+		// Draws a line from (x1,y1) to (x2,y2), not through Draw()
 		void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p = olc::WHITE, uint32_t pattern = 0xFFFFFFFF);
 		void DrawLine(const olc::vi2d& pos1, const olc::vi2d& pos2, Pixel p = olc::WHITE, uint32_t pattern = 0xFFFFFFFF);
+		// Draws a line between each pair of points, in one colour or with a colour
+		// per line. Cheaper than DrawLine() one by one, e.g. for debug overlays,
+		// and likewise not through Draw().
+		void DrawLines(const std::vector<olc::vi2d>& vPoints, Pixel p = olc::WHITE, uint32_t pattern = 0xFFFFFFFF);
+		void DrawLines(const std::vector<olc::vi2d>& vPoints, const std::vector<olc::Pixel>& vColours, uint32_t pattern = 0xFFFFFFFF);
 		// Draws a circle located at (x,y) with radius
 		void DrawCircle(int32_t x, int32_t y, int32_t radius, Pixel p = olc::WHITE, uint8_t mask = 0xFF);
 		void DrawCircle(const olc::vi2d& pos, int32_t radius, Pixel p = olc::WHITE, uint8_t mask = 0xFF);
-		// Fills a circle located at (x,y) with radius
+		// Fills a circle located at (x,y) with radius, not through Draw()
 		void FillCircle(int32_t x, int32_t y, int32_t radius, Pixel p = olc::WHITE);
 		void FillCircle(const olc::vi2d& pos, int32_t radius, Pixel p = olc::WHITE);
-		// Draws a rectangle at (x,y) to (x+w,y+h)
+		// Draws a rectangle at (x,y) to (x+w,y+h), from lines as DrawLine()
 		void DrawRect(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p = olc::WHITE);
 		void DrawRect(const olc::vi2d& pos, const olc::vi2d& size, Pixel p = olc::WHITE);
-		// Fills a rectangle at (x,y) to (x+w,y+h)
+		// Fills a rectangle at (x,y) to (x+w,y+h), not through Draw()
 		void FillRect(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p = olc::WHITE);
 		void FillRect(const olc::vi2d& pos, const olc::vi2d& size, Pixel p = olc::WHITE);
-		// Draws a triangle between points (x1,y1), (x2,y2) and (x3,y3)
+		// Draws a triangle between points (x1,y1), (x2,y2) and (x3,y3), from
+		// lines as DrawLine()
 		void DrawTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p = olc::WHITE);
 		void DrawTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p = olc::WHITE);
-		// Flat fills a triangle between points (x1,y1), (x2,y2) and (x3,y3)
+		// Flat fills a triangle between points (x1,y1), (x2,y2) and (x3,y3), not
+		// through Draw()
 		void FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p = olc::WHITE);
 		void FillTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p = olc::WHITE);
+		// Fills many triangles, every three vertices make one, in one colour or
+		// with a colour per triangle. Cheaper than FillTriangle() one by one, and
+		// likewise not through Draw().
+		void FillTriangles(const std::vector<olc::vi2d>& vVertices, Pixel p = olc::WHITE);
+		void FillTriangles(const std::vector<olc::vi2d>& vVertices, const std::vector<olc::Pixel>& vColours);
 		// Draws an entire sprite at location (x,y)
 		void DrawSprite(int32_t x, int32_t y, Sprite* sprite, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
 		void DrawSprite(const olc::vi2d& pos, Sprite* sprite, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
@@ -974,6 +1479,13 @@ namespace olc
 		// selected area is (ox,oy) to (ox+w,oy+h)
 		void DrawPartialSprite(int32_t x, int32_t y, Sprite* sprite, int32_t ox, int32_t oy, int32_t w, int32_t h, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
 		void DrawPartialSprite(const olc::vi2d& pos, Sprite* sprite, const olc::vi2d& sourcepos, const olc::vi2d& size, uint32_t scale = 1, uint8_t flip = olc::Sprite::NONE);
+		// Draws a sprite through an affine transform, sprite pixel (u,v) lands on
+		// vOrigin + u * vAxisX + v * vAxisY. Samples nearest, or bilinear with
+		// bFilter, and writes in the current pixel mode, but not through Draw().
+		void DrawSpriteTransformed(Sprite* sprite, const olc::vf2d& vOrigin, const olc::vf2d& vAxisX, const olc::vf2d& vAxisY, bool bFilter = false);
+		// Draws a sprite rotated to specified angle, as DrawRotatedDecal(), with
+		// DrawSpriteTransformed()
+		void DrawRotatedSprite(const olc::vf2d& pos, Sprite* sprite, const float fAngle, const olc::vf2d& center = { 0.0f, 0.0f }, const olc::vf2d& scale = { 1.0f, 1.0f }, bool bFilter = false);
 		// Draws a single line of text - traditional monospaced
 		void DrawString(int32_t x, int32_t y, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
 		void DrawString(const olc::vi2d& pos, const std::string& sText, Pixel col = olc::WHITE, uint32_t scale = 1);
@@ -985,11 +1497,18 @@ namespace olc
 
 		// Decal Quad functions
 		void SetDecalMode(const olc::DecalMode& mode);
+		// Decals drawn after this go in this sort layer, 0 at the back. Only
+		// layers with decal sorting enabled use it. Reset to 0 every frame.
+		void SetDecalSortLayer(uint16_t nSortLayer);
 		// Draws a whole decal, with optional scale and tinting
 		void DrawDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& scale = { 1.0f,1.0f }, const olc::Pixel& tint = olc::WHITE);
 		// Draws a region of a decal, with optional scale and tinting
 		void DrawPartialDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale = { 1.0f,1.0f }, const olc::Pixel& tint = olc::WHITE);
 		void DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint = olc::WHITE);
+		// As above, but for a region of a decal such as an olc::Atlas entry, source_pos is relative to the region
+		void DrawDecal(const olc::vf2d& pos, const olc::DecalRegion& region, const olc::vf2d& scale = { 1.0f,1.0f }, const olc::Pixel& tint = olc::WHITE);
+		void DrawPartialDecal(const olc::vf2d& pos, const olc::DecalRegion& region, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale = { 1.0f,1.0f }, const olc::Pixel& tint = olc::WHITE);
+		void DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, const olc::DecalRegion& region, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint = olc::WHITE);
 		// Draws fully user controlled 4 vertices, pos(pixels), uv(pixels), colours
 		void DrawExplicitDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, const olc::Pixel* col, uint32_t elements = 4);
 		// Draws a decal with 4 arbitrary points, warping the texture to look "correct"
@@ -1043,6 +1562,13 @@ namespace olc
 		olc::vf2d	vPixel = { 1.0f, 1.0f };
 		bool		bHasInputFocus = false;
 		bool		bHasMouseFocus = false;
+		// The window side of the above as of the start of this frame, the
+		// platform may be changing the originals from the render thread
+		olc::vi2d	vFrameWindowSize = { 0, 0 };
+		olc::vi2d	vFrameScreenPixelSize = { 4, 4 };
+		olc::vi2d	vFrameMouseWindowPos = { 0, 0 };
+		bool		bFrameInputFocus = false;
+		bool		bFrameMouseFocus = false;
 		bool		bEnableVSYNC = false;
 		float		fFrameTimer = 1.0f;
 		float		fLastElapsed = 0.0f;
@@ -1055,10 +1581,77 @@ namespace olc
 		uint32_t	nLastFPS = 0;
 		bool        bPixelCohesion = false;
 		DecalMode   nDecalMode = DecalMode::NORMAL;
+		uint16_t	nDecalSortLayer = 0;
+		std::vector<uint64_t> vDecalSortKeys[2];
+		std::vector<uint32_t> vDecalSortOrder[2];
+		std::vector<DecalInstance> vDecalSortScratch;
 		std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)> funcPixelMode;
-		std::chrono::time_point<std::chrono::system_clock> m_tp1, m_tp2;
+		uint32_t	nPixelModeVersion = 0;
+		std::chrono::time_point<std::chrono::steady_clock> m_tp1, m_tp2;
+		int64_t		nFrameTimeNs = 0;
+		int64_t		nSessionTimeNs = 0;
+		uint64_t	nFrameIndex = 0;
 		std::vector<olc::vi2d> vFontSpacing;
 
+		// Frame pacing
+		float		fFrameRateLimit = 0.0f;
+		float		fIdleFrameRate = 20.0f;
+		bool		bIdle = false;
+		std::chrono::steady_clock::time_point tpFrameDeadline;
+		std::chrono::nanoseconds nSpinMargin = std::chrono::milliseconds(1);
+		std::array<int64_t, 256> vFrameIntervals = { 0 };
+		uint32_t	nFrameIntervals = 0;
+
+		// Deferred drawing, a recorded call with the pixel mode it was made in
+		struct DrawCommand
+		{
+			enum class Type : uint8_t { CLEAR, FILL_RECT, FILL_CIRCLE, FILL_TRIANGLE, DRAW_SPRITE, DRAW_PARTIAL_SPRITE, DRAW_TRANSFORMED };
+			Type type = Type::CLEAR;
+			olc::Pixel p;
+			int32_t v[6] = { 0 };
+			float f[6] = { 0 };
+			olc::Sprite* sprite = nullptr;
+			uint32_t scale = 1;
+			uint8_t flip = 0;
+			Pixel::Mode nMode = Pixel::NORMAL;
+			float fBlend = 1.0f;
+			uint32_t nPixelFunc = 0;
+			// Area of the draw target it may touch, end exclusive
+			olc::vi2d vMin, vMax;
+		};
+		bool		bDeferred = false;
+		std::unique_ptr<olc::ThreadPool> pDeferredPool;
+		// Session recording and replay
+		std::unique_ptr<olc::SessionLog> pRecording;
+		olc::SessionFrame* pReplayFrame = nullptr;
+		std::vector<DrawCommand> vDeferred;
+		std::vector<std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)>> vDeferredPixelFuncs;
+		uint32_t	nDeferredPixelModeVersion = 0;
+		std::vector<std::vector<uint32_t>> vDeferredTiles;
+		bool olc_Defer(DrawCommand::Type type, const Pixel& p, const olc::vi2d& vMin, const olc::vi2d& vMax, std::initializer_list<int32_t> args, olc::Sprite* sprite = nullptr, uint32_t scale = 1, uint8_t flip = 0, std::initializer_list<float> fargs = {});
+		void olc_GetClip(olc::vi2d& vMin, olc::vi2d& vMax) const;
+
+		// Where and how filled primitives write, resolved once per call
+		struct SpanTarget
+		{
+			olc::Sprite* pTarget = nullptr;
+			olc::vi2d vClipMin, vClipMax;
+			Pixel::Mode nMode = Pixel::NORMAL;
+			float fBlend = 1.0f;
+			const std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)>* pFunc = nullptr;
+		};
+		SpanTarget olc_GetSpanTarget();
+		void olc_FillSpan(const SpanTarget& st, int32_t x1, int32_t x2, int32_t y, Pixel p);
+		void olc_BlendSpan(const SpanTarget& st, int32_t x, int32_t y, const Pixel* pSrc, int32_t n);
+		void olc_PlotClipped(const SpanTarget& st, int32_t x, int32_t y, Pixel p);
+		void olc_DrawLine(const SpanTarget& st, int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p, uint32_t pattern);
+		void olc_FillTriangle(const SpanTarget& st, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p);
+
+		// Update/render pipelining
+		bool		bPipelined = false;
+		uint32_t	nPipelineBuffers = 2;
+		std::string	sPendingTitle;
+
 		// State of keyboard		
 		bool		pKeyNewState[256] = { 0 };
 		bool		pKeyOldState[256] = { 0 };
@@ -1069,6 +1662,15 @@ namespace olc
 		bool		pMouseOldState[nMouseButtons] = { 0 };
 		HWButton	pMouseState[nMouseButtons] = { 0 };
 
+		// Changes to the new states above are queued by the platform, so a frame
+		// only looks at the keys and buttons that changed. Also guards the mouse
+		// position, wheel, focus and window size the platform reports.
+		std::mutex	muxInput;
+		std::vector<olc::InputEvent> vInputQueue;
+		std::vector<olc::InputEvent> vInputScan;
+		std::vector<olc::InputEvent> vInputEvents;
+		std::vector<HWButton*> vInputFlagged;
+
 		// The main engine thread
 		void		EngineThread();
 
@@ -1083,9 +1685,18 @@ namespace olc
 		void olc_UpdateMouseWheel(int32_t delta);
 		void olc_UpdateWindowSize(int32_t x, int32_t y);
 		void olc_UpdateViewport();
+		void olc_LatchWindowState();
 		void olc_ConstructFontSheet();
 		void olc_CoreUpdate();
+		void olc_UpdateFrame();
+		void olc_RenderFrame(std::vector<LayerDesc>& vRenderLayers);
+		void olc_SubmitDecal(DecalInstance& di);
+		void olc_SortDecals(std::vector<DecalInstance>& vDecals);
+		void olc_SubmitFrame();
+		void olc_RunPipelined();
+		void olc_PaceFrame();
 		void olc_PrepareEngine();
+		void olc_PrepareHeadless();
 		void olc_UpdateMouseState(int32_t button, bool state);
 		void olc_UpdateKeyState(int32_t key, bool state);
 		void olc_UpdateMouseFocus(bool state);
@@ -1130,6 +1741,95 @@ namespace olc
 	protected:
 		static PixelGameEngine* pge;
 	};
+
+	// O------------------------------------------------------------------------------O
+	// | olc::AssetWatcher - Reloads images when their files change on disk           |
+	// O------------------------------------------------------------------------------O
+	// Changed files are decoded on a thread of the watcher's own and swapped into
+	// their sprites just before the next OnUserUpdate(), so the Sprite* and Decal*
+	// handed out earlier stay valid and show the new image from that frame on.
+	// Watches the directories with inotify on Linux, which also sees editors that
+	// save by renaming, and polls modification times elsewhere or when inotify is
+	// not available. Create it after the engine and keep it as long as the engine
+	// runs, for example as a member of the application.
+	class AssetWatcher : public olc::PGEX
+	{
+	public:
+		// One reload swapped in, or failed, timed from when the change was seen
+		struct Reload
+		{
+			std::string sFile;
+			olc::rcode result = olc::rcode::FAIL;
+			float fDecodeMs = 0.0f;  // On the watcher thread
+			float fLatencyMs = 0.0f; // Until the image was swapped in
+		};
+
+		AssetWatcher(bool bPolling = false, uint32_t nPollMs = 250);
+		~AssetWatcher();
+		AssetWatcher(const AssetWatcher&) = delete;
+		AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+	public:
+		// Reloads the renderable from sFile. Its sprite keeps the format and layout
+		// it has now; if it failed to load, the first good reload creates it.
+		void Watch(olc::Renderable& r, const std::string& sFile, bool filter = false, bool clamp = true);
+		// Reloads the sprite from sFile and uploads it to the decal, if any
+		void Watch(olc::Sprite* spr, olc::Decal* decal, const std::string& sFile);
+		void Unwatch(const olc::Renderable& r);
+		void Unwatch(const olc::Sprite* spr);
+		// Swaps in everything decoded so far, returns the number of images. Runs
+		// before every OnUserUpdate() already.
+		uint32_t Apply();
+		// Called from Apply() for every reload, to report it
+		void SetOnReload(std::function<void(const olc::AssetWatcher::Reload&)> func);
+		// True when the files are polled rather than watched with inotify
+		bool IsPolling() const;
+
+	protected:
+		void OnBeforeUserUpdate(float& fElapsedTime) override;
+
+	private:
+		struct sEntry
+		{
+			olc::Renderable* pRenderable = nullptr;
+			olc::Sprite* pSprite = nullptr;
+			olc::Decal* pDecal = nullptr;
+			std::string sFile;
+			std::string sDirectory;
+			std::string sName;
+			bool filter = false;
+			bool clamp = true;
+			olc::Sprite::Format format = olc::Sprite::Format::RGBA8;
+			olc::Sprite::Layout layout = olc::Sprite::Layout::LINEAR;
+			int64_t nTime = 0; // When polled, the modification time last seen
+		};
+		struct sDecoded
+		{
+			uint64_t nEntry = 0;
+			std::unique_ptr<olc::Sprite> pSprite;
+			Reload reload;
+			std::chrono::steady_clock::time_point tpSeen;
+		};
+
+		void Add(sEntry entry);
+		void WatcherThread();
+		void Decode(const std::vector<uint64_t>& vEntries, std::chrono::steady_clock::time_point tpSeen);
+		static int64_t FileTime(const std::string& sFile);
+
+		std::map<uint64_t, sEntry> mapEntries;
+		uint64_t nNextEntry = 1;
+		std::vector<sDecoded> vDecoded;
+		std::function<void(const Reload&)> funcOnReload;
+		std::mutex mtx;
+		std::condition_variable cvStop;
+		bool bStop = false;
+		bool bPolling = true;
+		uint32_t nPollMs = 250;
+		int nInotify = -1;
+		int nWake[2] = { -1, -1 };
+		std::map<int, std::string> mapDirectories;
+		std::thread thread;
+	};
 }
 
 #pragma endregion
@@ -1246,6 +1946,70 @@ namespace olc
 	Pixel PixelLerp(const olc::Pixel& p1, const olc::Pixel& p2, float t)
 	{ return (p2 * t) + p1 * (1.0f - t); }
 
+	// O------------------------------------------------------------------------------O
+	// | olc::PixelBuffer IMPLEMENTATION                                              |
+	// O------------------------------------------------------------------------------O
+	PixelBuffer::PixelBuffer(olc::PixelBuffer&& other) noexcept
+	{ *this = std::move(other); }
+
+	PixelBuffer& PixelBuffer::operator=(olc::PixelBuffer&& other) noexcept
+	{
+		if (this != &other)
+		{
+			clear();
+			pData = other.pData; nSize = other.nSize; funcRelease = std::move(other.funcRelease);
+			other.pData = nullptr; other.nSize = 0; other.funcRelease = nullptr;
+		}
+		return *this;
+	}
+
+	PixelBuffer::~PixelBuffer()
+	{ clear(); }
+
+	void PixelBuffer::resize(size_t nPixels)
+	{ resize(nPixels, olc::Pixel()); }
+
+	void PixelBuffer::resize(size_t nPixels, const olc::Pixel& p)
+	{
+		if (nPixels <= nSize)
+		{
+			// Shrinking keeps the allocation, as std::vector does
+			if (nPixels == 0) clear(); else nSize = nPixels;
+			return;
+		}
+
+		olc::Pixel* pNew = (olc::Pixel*)std::malloc(nPixels * sizeof(olc::Pixel));
+		if (pNew == nullptr) throw std::bad_alloc();
+		if (nSize > 0) std::memcpy(pNew, pData, nSize * sizeof(olc::Pixel));
+		std::fill(pNew + nSize, pNew + nPixels, p);
+		clear();
+		pData = pNew; nSize = nPixels;
+	}
+
+	void PixelBuffer::clear()
+	{
+		if (pData != nullptr)
+		{
+			if (funcRelease) funcRelease(pData); else std::free(pData);
+		}
+		pData = nullptr; nSize = 0; funcRelease = nullptr;
+	}
+
+	void PixelBuffer::allocate_uninitialised(size_t nPixels)
+	{
+		clear();
+		if (nPixels == 0) return;
+		pData = (olc::Pixel*)std::malloc(nPixels * sizeof(olc::Pixel));
+		if (pData == nullptr) throw std::bad_alloc();
+		nSize = nPixels;
+	}
+
+	void PixelBuffer::adopt(olc::Pixel* pNewData, size_t nPixels, ReleaseFunc funcNewRelease)
+	{
+		clear();
+		pData = pNewData; nSize = nPixels; funcRelease = std::move(funcNewRelease);
+	}
+
 	// O------------------------------------------------------------------------------O
 	// | olc::Sprite IMPLEMENTATION                                                   |
 	// O------------------------------------------------------------------------------O
@@ -1258,66 +2022,222 @@ namespace olc
 	Sprite::Sprite(int32_t w, int32_t h)
 	{		
 		width = w;		height = h;
-		pColData.resize(width * height);
 		pColData.resize(width * height, nDefaultPixel);
 	}
 
+	Sprite::Sprite(int32_t w, int32_t h, olc::Sprite::Format format)
+	{
+		width = w; height = h;
+		this->format = format;
+		if (format == Format::RGBA8)
+			pColData.resize(size_t(width) * size_t(height), nDefaultPixel);
+		else // Packed into as many whole olc::Pixels as it takes, all zero
+			pColData.resize((size_t(width) * size_t(height) * GetFormatSize(format) + 3) / 4, olc::BLANK);
+	}
+
 	Sprite::~Sprite()
 	{ pColData.clear();	}
 
-	// To Be Deprecated
-	//olc::rcode Sprite::LoadFromPGESprFile(const std::string& sImageFile, olc::ResourcePack* pack)
-	//{
-	//	if (pColData) delete[] pColData;
-	//	auto ReadData = [&](std::istream& is)
-	//	{
-	//		is.read((char*)&width, sizeof(int32_t));
-	//		is.read((char*)&height, sizeof(int32_t));
-	//		pColData = new Pixel[width * height];
-	//		is.read((char*)pColData, (size_t)width * (size_t)height * sizeof(uint32_t));
-	//	};
-
-	//	// These are essentially Memory Surfaces represented by olc::Sprite
-	//	// which load very fast, but are completely uncompressed
-	//	if (pack == nullptr)
-	//	{
-	//		std::ifstream ifs;
-	//		ifs.open(sImageFile, std::ifstream::binary);
-	//		if (ifs.is_open())
-	//		{
-	//			ReadData(ifs);
-	//			return olc::OK;
-	//		}
-	//		else
-	//			return olc::FAIL;
-	//	}
-	//	else
-	//	{
-	//		ResourceBuffer rb = pack->GetFileBuffer(sImageFile);
-	//		std::istream is(&rb);
-	//		ReadData(is);
-	//		return olc::OK;
-	//	}
-	//	return olc::FAIL;
-	//}
-
-	//olc::rcode Sprite::SaveToPGESprFile(const std::string& sImageFile)
-	//{
-	//	if (pColData == nullptr) return olc::FAIL;
-
-	//	std::ofstream ofs;
-	//	ofs.open(sImageFile, std::ifstream::binary);
-	//	if (ofs.is_open())
-	//	{
-	//		ofs.write((char*)&width, sizeof(int32_t));
-	//		ofs.write((char*)&height, sizeof(int32_t));
-	//		ofs.write((char*)pColData, std::streamsize(width) * std::streamsize(height) * sizeof(uint32_t));
-	//		ofs.close();
-	//		return olc::OK;
-	//	}
-
-	//	return olc::FAIL;
-	//}
+	// .pgespr v2 - A 64 byte header followed by the pixels, raw or LZ packed. Raw
+	// pixels sit 64 byte aligned, so files can be mapped and used as pColData in
+	// place. v1 files, just width, height and raw pixels, are still read.
+	struct sPGESprHeader
+	{
+		uint32_t nMagic = 0x53454750; // "PGES"
+		uint32_t nVersion = 2;
+		int32_t nWidth = 0;
+		int32_t nHeight = 0;
+		uint32_t nCodec = uint32_t(olc::ResourceCodec::RAW);
+		uint32_t nReserved = 0;
+		uint64_t nStored = 0;
+		// Describe the image this was made from, zero unless written by the cache
+		uint64_t nSourceSize = 0;
+		int64_t nSourceTime = 0;
+		uint64_t nSourceHash = 0;
+		uint8_t nPadding[8] = { 0 };
+	};
+	static_assert(sizeof(sPGESprHeader) == 64, "pgespr header must stay 64 bytes");
+
+	// FNV-1a, 64 bit
+	static uint64_t HashPGESpr(const char* pData, size_t nSize, uint64_t nHash = 0xcbf29ce484222325ULL)
+	{
+		for (size_t i = 0; i < nSize; i++)
+			nHash = (nHash ^ uint8_t(pData[i])) * 0x100000001b3ULL;
+		return nHash;
+	}
+
+	static uint64_t HashPGESprFile(const std::string& sFile)
+	{
+		std::ifstream ifs(sFile, std::ifstream::binary);
+		std::vector<char> vChunk(1 << 16);
+		uint64_t nHash = 0xcbf29ce484222325ULL;
+		while (ifs)
+		{
+			ifs.read(vChunk.data(), vChunk.size());
+			nHash = HashPGESpr(vChunk.data(), size_t(ifs.gcount()), nHash);
+		}
+		return nHash;
+	}
+
+	// Fills h from the start of a file held in memory, false if it is not one
+	static bool ParsePGESpr(const char* pData, size_t nSize, sPGESprHeader& h)
+	{
+		if (nSize >= sizeof(h) && std::memcmp(pData, &h.nMagic, sizeof(h.nMagic)) == 0)
+		{
+			std::memcpy(&h, pData, sizeof(h));
+			if (h.nVersion != 2 || h.nWidth <= 0 || h.nHeight <= 0 || h.nStored > nSize - sizeof(h)) return false;
+			if (h.nCodec == uint32_t(olc::ResourceCodec::RAW))
+				return h.nStored == size_t(h.nWidth) * size_t(h.nHeight) * sizeof(olc::Pixel);
+			return h.nCodec == uint32_t(olc::ResourceCodec::LZ);
+		}
+
+		int32_t nDims[2];
+		if (nSize < sizeof(nDims)) return false;
+		std::memcpy(nDims, pData, sizeof(nDims));
+		if (nDims[0] <= 0 || nDims[1] <= 0) return false;
+		h.nVersion = 1; h.nWidth = nDims[0]; h.nHeight = nDims[1];
+		h.nCodec = uint32_t(olc::ResourceCodec::RAW);
+		h.nStored = size_t(h.nWidth) * size_t(h.nHeight) * sizeof(olc::Pixel);
+		return h.nStored <= nSize - sizeof(nDims);
+	}
+
+	static size_t PayloadOffsetPGESpr(const sPGESprHeader& h)
+	{ return h.nVersion == 1 ? 2 * sizeof(int32_t) : sizeof(sPGESprHeader); }
+
+	// Copies or unpacks the pixels of a parsed file into the sprite
+	static olc::rcode DecodePGESpr(olc::Sprite* spr, const char* pData, const sPGESprHeader& h)
+	{
+		const size_t nPixels = size_t(h.nWidth) * size_t(h.nHeight);
+		const uint8_t* pPayload = (const uint8_t*)pData + PayloadOffsetPGESpr(h);
+		spr->pColData.allocate_uninitialised(nPixels);
+		if (h.nCodec == uint32_t(olc::ResourceCodec::LZ))
+		{
+			if (!olc::LZCodec::Decompress(pPayload, size_t(h.nStored), (uint8_t*)spr->pColData.data(), nPixels * sizeof(olc::Pixel)))
+			{
+				spr->pColData.clear();
+				return olc::rcode::FAIL;
+			}
+		}
+		else
+			std::memcpy(spr->pColData.data(), pPayload, nPixels * sizeof(olc::Pixel));
+		spr->width = h.nWidth; spr->height = h.nHeight;
+		return olc::rcode::OK;
+	}
+
+	// Loads a .pgespr from disk, raw images are mapped rather than read. funcAccept
+	// can turn down the file after its header has been checked.
+	static olc::rcode LoadPGESpr(olc::Sprite* spr, const std::string& sFile, const std::function<bool(const sPGESprHeader&)>& funcAccept)
+	{
+		sPGESprHeader h;
+#if !defined(_WIN32)
+		int fd = open(sFile.c_str(), O_RDONLY);
+		if (fd < 0) return olc::rcode::NO_FILE;
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return olc::rcode::FAIL; }
+		const size_t nSize = size_t(st.st_size);
+		// Private, so drawing to the sprite copies pages rather than writing the
+		// file. Files are only ever replaced by rename, never truncated under us.
+		void* pMap = mmap(nullptr, nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (pMap == MAP_FAILED) return olc::rcode::FAIL;
+		const char* pData = (const char*)pMap;
+
+		olc::rcode rc = olc::rcode::FAIL;
+		if (ParsePGESpr(pData, nSize, h) && (!funcAccept || funcAccept(h)))
+		{
+			if (h.nCodec == uint32_t(olc::ResourceCodec::RAW))
+			{
+				spr->pColData.adopt((olc::Pixel*)(pData + PayloadOffsetPGESpr(h)), size_t(h.nWidth) * size_t(h.nHeight),
+					[pMap, nSize](olc::Pixel*) { munmap(pMap, nSize); });
+				spr->width = h.nWidth; spr->height = h.nHeight;
+				return olc::rcode::OK;
+			}
+			rc = DecodePGESpr(spr, pData, h);
+		}
+		munmap(pMap, nSize);
+		return rc;
+#else
+		std::ifstream ifs(sFile, std::ifstream::binary | std::ifstream::ate);
+		if (!ifs.is_open()) return olc::rcode::NO_FILE;
+		std::vector<char> vData(size_t(ifs.tellg()));
+		ifs.seekg(0);
+		ifs.read(vData.data(), vData.size());
+		if (!ifs || !ParsePGESpr(vData.data(), vData.size(), h) || (funcAccept && !funcAccept(h))) return olc::rcode::FAIL;
+		return DecodePGESpr(spr, vData.data(), h);
+#endif
+	}
+
+	static olc::rcode SavePGESpr(const olc::Sprite* spr, const std::string& sFile, olc::ResourceCodec codec, sPGESprHeader h)
+	{
+		if (spr->width <= 0 || spr->height <= 0 || spr->pColData.size() != size_t(spr->width) * size_t(spr->height))
+			return olc::rcode::FAIL;
+
+		h.nWidth = spr->width; h.nHeight = spr->height;
+		h.nCodec = uint32_t(olc::ResourceCodec::RAW);
+		h.nStored = spr->pColData.size() * sizeof(olc::Pixel);
+		const uint8_t* pPayload = (const uint8_t*)spr->pColData.data();
+
+		std::vector<uint8_t> vPacked;
+		if (codec == olc::ResourceCodec::LZ)
+		{
+			vPacked.resize(olc::LZCodec::Bound(size_t(h.nStored)));
+			size_t nPacked = olc::LZCodec::Compress(pPayload, size_t(h.nStored), vPacked.data(), vPacked.size());
+			if (nPacked > 0 && nPacked < h.nStored)
+			{
+				h.nCodec = uint32_t(olc::ResourceCodec::LZ);
+				h.nStored = nPacked;
+				pPayload = vPacked.data();
+			}
+		}
+
+		// Write alongside and swap in, so readers never see half a file and any
+		// sprite still mapping the old one keeps its pages
+		const std::string sTemp = sFile + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+		std::error_code ec;
+		{
+			std::ofstream ofs(sTemp, std::ofstream::binary);
+			if (!ofs.is_open()) return olc::rcode::FAIL;
+			ofs.write((const char*)&h, sizeof(h));
+			ofs.write((const char*)pPayload, std::streamsize(h.nStored));
+			if (!ofs.good())
+			{
+				ofs.close();
+				_gfs::remove(sTemp, ec);
+				return olc::rcode::FAIL;
+			}
+		}
+		_gfs::rename(sTemp, sFile, ec);
+		if (ec)
+		{
+			_gfs::remove(sTemp, ec);
+			return olc::rcode::FAIL;
+		}
+		return olc::rcode::OK;
+	}
+
+	olc::rcode Sprite::LoadFromPGESprFile(const std::string& sImageFile, olc::ResourcePack* pack)
+	{
+		format = Format::RGBA8;
+		layout = Layout::LINEAR;
+		if (pack == nullptr)
+			return LoadPGESpr(this, sImageFile, nullptr);
+
+		ResourceBuffer rb = pack->GetFileBuffer(sImageFile);
+		sPGESprHeader h;
+		if (!ParsePGESpr(rb.vMemory.data(), rb.vMemory.size(), h)) return olc::rcode::FAIL;
+		return DecodePGESpr(this, rb.vMemory.data(), h);
+	}
+
+	olc::rcode Sprite::SaveToPGESprFile(const std::string& sImageFile, olc::ResourceCodec codec)
+	{
+		if (format != Format::RGBA8 || layout != Layout::LINEAR)
+		{
+			std::unique_ptr<olc::Sprite> spr(Convert(Format::RGBA8));
+			spr->SetLayout(Layout::LINEAR);
+			return SavePGESpr(spr.get(), sImageFile, codec, sPGESprHeader());
+		}
+		return SavePGESpr(this, sImageFile, codec, sPGESprHeader());
+	}
 
 	void Sprite::SetSampleMode(olc::Sprite::Mode mode)
 	{ modeSample = mode; }
@@ -1328,59 +2248,333 @@ namespace olc
 	bool Sprite::SetPixel(const olc::vi2d& a, Pixel p)
 	{ return SetPixel(a.x, a.y, p); }
 
+	// One texel of a packed format to and from olc::Pixel
+	static inline olc::Pixel UnpackTexel(olc::Sprite::Format format, const uint8_t* p)
+	{
+		switch (format)
+		{
+		case olc::Sprite::Format::R8: return olc::Pixel(p[0], 0, 0);
+		case olc::Sprite::Format::RG8: return olc::Pixel(p[0], p[1], 0);
+		case olc::Sprite::Format::R32F:
+		{
+			float f;
+			std::memcpy(&f, p, sizeof(f));
+			return olc::Pixel(uint8_t(std::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f), 0, 0);
+		}
+		default:
+		{
+			olc::Pixel d;
+			std::memcpy(&d.n, p, sizeof(d.n));
+			return d;
+		}
+		}
+	}
+
+	static inline void PackTexel(olc::Sprite::Format format, const olc::Pixel& s, uint8_t* p)
+	{
+		switch (format)
+		{
+		case olc::Sprite::Format::R8: p[0] = s.r; break;
+		case olc::Sprite::Format::RG8: p[0] = s.r; p[1] = s.g; break;
+		case olc::Sprite::Format::R32F:
+		{
+			const float f = float(s.r) / 255.0f;
+			std::memcpy(p, &f, sizeof(f));
+			break;
+		}
+		default: std::memcpy(p, &s.n, sizeof(s.n)); break;
+		}
+	}
+
 	Pixel Sprite::GetPixel(int32_t x, int32_t y) const
 	{
+		size_t i;
 		if (modeSample == olc::Sprite::Mode::NORMAL)
 		{
 			if (x >= 0 && x < width && y >= 0 && y < height)
-				return pColData[y * width + x];
+				i = GetTexelIndex(x, y);
 			else
 				return Pixel(0, 0, 0, 0);
 		}
 		else
 		{
-			return pColData[abs(y % height) * width + abs(x % width)];
+			i = GetTexelIndex(abs(x % width), abs(y % height));
 		}
+
+		if (format == Format::RGBA8) return pColData[i];
+		return UnpackTexel(format, GetRawData() + i * GetFormatSize(format));
 	}
 
 	bool Sprite::SetPixel(int32_t x, int32_t y, Pixel p)
 	{
 		if (x >= 0 && x < width && y >= 0 && y < height)
 		{
-			pColData[y * width + x] = p;
+			if (format == Format::RGBA8)
+				pColData[GetTexelIndex(x, y)] = p;
+			else
+				PackTexel(format, p, GetRawData() + GetTexelIndex(x, y) * GetFormatSize(format));
 			return true;
 		}
 		else
 			return false;
 	}
 
-	Pixel Sprite::Sample(float x, float y) const
+	olc::Sprite::Format Sprite::GetFormat() const
+	{ return format; }
+
+	uint32_t Sprite::GetFormatSize(olc::Sprite::Format format)
 	{
-		int32_t sx = std::min((int32_t)((x * (float)width)), width - 1);
-		int32_t sy = std::min((int32_t)((y * (float)height)), height - 1);
-		return GetPixel(sx, sy);
+		switch (format)
+		{
+		case Format::R8: return 1;
+		case Format::RG8: return 2;
+		default: return 4;
+		}
 	}
 
-	Pixel Sprite::SampleBL(float u, float v) const
-	{
-		u = u * width - 0.5f;
-		v = v * height - 0.5f;
-		int x = (int)floor(u); // cast to int rounds toward zero, not downward
-		int y = (int)floor(v); // Thanks @joshinils
-		float u_ratio = u - x;
-		float v_ratio = v - y;
-		float u_opposite = 1 - u_ratio;
-		float v_opposite = 1 - v_ratio;
+	uint8_t* Sprite::GetRawData()
+	{ return reinterpret_cast<uint8_t*>(pColData.data()); }
 
-		olc::Pixel p1 = GetPixel(std::max(x, 0), std::max(y, 0));
-		olc::Pixel p2 = GetPixel(std::min(x + 1, (int)width - 1), std::max(y, 0));
-		olc::Pixel p3 = GetPixel(std::max(x, 0), std::min(y + 1, (int)height - 1));
-		olc::Pixel p4 = GetPixel(std::min(x + 1, (int)width - 1), std::min(y + 1, (int)height - 1));
+	const uint8_t* Sprite::GetRawData() const
+	{ return reinterpret_cast<const uint8_t*>(pColData.data()); }
+
+	olc::Sprite* Sprite::Convert(olc::Sprite::Format format) const
+	{
+		// Same layout, so texels convert one to one, tile padding included
+		olc::Sprite* spr = new olc::Sprite();
+		spr->width = width; spr->height = height;
+		spr->format = format;
+		spr->layout = layout;
+		spr->modeSample = modeSample;
+		const size_t nTexels = GetStorageTexels();
+		spr->pColData.resize((nTexels * GetFormatSize(format) + 3) / 4, olc::BLANK);
+		ConvertPixels(this->format, GetRawData(), format, spr->GetRawData(), nTexels);
+		return spr;
+	}
+
+	olc::Sprite::Layout Sprite::GetLayout() const
+	{ return layout; }
+
+	size_t Sprite::GetStorageTexels() const
+	{
+		if (layout == Layout::LINEAR) return size_t(width) * size_t(height);
+		return size_t((width + 7) & ~7) * size_t((height + 7) & ~7);
+	}
+
+	// Copies every row of texels between linear order and 8x8 tiles, in pieces
+	// of up to eight texels, the width of one tile row
+	template<size_t nSize>
+	static void CopyTiles(const uint8_t* pFrom, uint8_t* pTo, int32_t w, int32_t h, bool bToTiled)
+	{
+		const int32_t nTilesX = (w + 7) >> 3;
+		for (int32_t y = 0; y < h; y++)
+			for (int32_t tx = 0; tx < nTilesX; tx++)
+			{
+				const size_t nLinear = (size_t(y) * size_t(w) + size_t(tx) * 8) * nSize;
+				const size_t nTiled = olc::Sprite::GetTiledIndex(tx * 8, y, nTilesX) * nSize;
+				const uint8_t* s = pFrom + (bToTiled ? nLinear : nTiled);
+				uint8_t* d = pTo + (bToTiled ? nTiled : nLinear);
+				if (tx * 8 + 8 <= w)
+					std::memcpy(d, s, 8 * nSize);
+				else
+					std::memcpy(d, s, size_t(w - tx * 8) * nSize);
+			}
+	}
+
+	void Sprite::SetLayout(olc::Sprite::Layout layout)
+	{
+		if (layout == this->layout) return;
+
+		const olc::Sprite::Layout layoutFrom = this->layout;
+		this->layout = layout;
+		olc::PixelBuffer pNewData;
+		pNewData.allocate_uninitialised((GetStorageTexels() * GetFormatSize(format) + 3) / 4);
+		// Tile padding is never read as a texel, but is kept defined
+		if (layout == Layout::TILED && ((width | height) & 7))
+			std::fill(pNewData.data(), pNewData.data() + pNewData.size(), olc::Pixel(0, 0, 0, 0));
+
+		const uint8_t* pFrom = GetRawData();
+		uint8_t* pTo = reinterpret_cast<uint8_t*>(pNewData.data());
+		const bool bToTiled = layoutFrom == Layout::LINEAR;
+		switch (GetFormatSize(format))
+		{
+		case 1: CopyTiles<1>(pFrom, pTo, width, height, bToTiled); break;
+		case 2: CopyTiles<2>(pFrom, pTo, width, height, bToTiled); break;
+		default: CopyTiles<4>(pFrom, pTo, width, height, bToTiled); break;
+		}
+		pColData = std::move(pNewData);
+	}
+
+	void Sprite::ConvertPixels(olc::Sprite::Format formatFrom, const void* pFrom, olc::Sprite::Format formatTo, void* pTo, size_t nCount)
+	{
+		const uint8_t* s = static_cast<const uint8_t*>(pFrom);
+		uint8_t* d = static_cast<uint8_t*>(pTo);
+		if (formatFrom == formatTo)
+		{
+			std::memcpy(d, s, nCount * GetFormatSize(formatFrom));
+			return;
+		}
+
+		// Straight loops for the common pairs, so they vectorise
+		if (formatFrom == Format::RGBA8)
+		{
+			switch (formatTo)
+			{
+			case Format::R8: for (size_t i = 0; i < nCount; i++) d[i] = s[i * 4]; return;
+			case Format::RG8: for (size_t i = 0; i < nCount; i++) { d[i * 2] = s[i * 4]; d[i * 2 + 1] = s[i * 4 + 1]; } return;
+			case Format::R32F:
+				for (size_t i = 0; i < nCount; i++) { const float f = float(s[i * 4]) / 255.0f; std::memcpy(d + i * 4, &f, 4); }
+				return;
+			default: break;
+			}
+		}
+		if (formatTo == Format::RGBA8)
+		{
+			switch (formatFrom)
+			{
+			case Format::R8:
+				for (size_t i = 0; i < nCount; i++) { d[i * 4] = s[i]; d[i * 4 + 1] = 0; d[i * 4 + 2] = 0; d[i * 4 + 3] = 255; }
+				return;
+			case Format::RG8:
+				for (size_t i = 0; i < nCount; i++) { d[i * 4] = s[i * 2]; d[i * 4 + 1] = s[i * 2 + 1]; d[i * 4 + 2] = 0; d[i * 4 + 3] = 255; }
+				return;
+			default: break;
+			}
+		}
+
+		// Everything else goes through olc::Pixel
+		const uint32_t nFrom = GetFormatSize(formatFrom), nTo = GetFormatSize(formatTo);
+		for (size_t i = 0; i < nCount; i++)
+			PackTexel(formatTo, UnpackTexel(formatFrom, s + i * nFrom), d + i * nTo);
+	}
+
+	Pixel Sprite::Sample(float x, float y) const
+	{
+		int32_t sx = std::min((int32_t)((x * (float)width)), width - 1);
+		int32_t sy = std::min((int32_t)((y * (float)height)), height - 1);
+		return GetPixel(sx, sy);
+	}
+
+	Pixel Sprite::SampleBL(float u, float v) const
+	{
+		u = u * width - 0.5f;
+		v = v * height - 0.5f;
+		int x = (int)floor(u); // cast to int rounds toward zero, not downward
+		int y = (int)floor(v); // Thanks @joshinils
+		float u_ratio = u - x;
+		float v_ratio = v - y;
+		float u_opposite = 1 - u_ratio;
+		float v_opposite = 1 - v_ratio;
+
+		olc::Pixel p1 = GetPixel(std::max(x, 0), std::max(y, 0));
+		olc::Pixel p2 = GetPixel(std::min(x + 1, (int)width - 1), std::max(y, 0));
+		olc::Pixel p3 = GetPixel(std::max(x, 0), std::min(y + 1, (int)height - 1));
+		olc::Pixel p4 = GetPixel(std::min(x + 1, (int)width - 1), std::min(y + 1, (int)height - 1));
 
 		return olc::Pixel(
 			(uint8_t)((p1.r * u_opposite + p2.r * u_ratio) * v_opposite + (p3.r * u_opposite + p4.r * u_ratio) * v_ratio),
 			(uint8_t)((p1.g * u_opposite + p2.g * u_ratio) * v_opposite + (p3.g * u_opposite + p4.g * u_ratio) * v_ratio),
-			(uint8_t)((p1.b * u_opposite + p2.b * u_ratio) * v_opposite + (p3.b * u_opposite + p4.b * u_ratio) * v_ratio));
+			(uint8_t)((p1.b * u_opposite + p2.b * u_ratio) * v_opposite + (p3.b * u_opposite + p4.b * u_ratio) * v_ratio),
+			(uint8_t)((p1.a * u_opposite + p2.a * u_ratio) * v_opposite + (p3.a * u_opposite + p4.a * u_ratio) * v_ratio));
+	}
+
+	// Bilinear blend of the texels a b (top) and c d (bottom) with 8 bit weights,
+	// rounded after each pass so the SIMD and scalar paths agree exactly
+	static inline olc::Pixel BlendTexels(olc::Pixel a, olc::Pixel b, olc::Pixel c, olc::Pixel d, uint32_t wx, uint32_t wy)
+	{
+#if defined(OLC_SIMD_SSE2)
+		// All four channels of two texels side by side in 16 bit lanes
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i half = _mm_set1_epi16(128);
+		__m128i ab = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, int(b.n), int(a.n)), zero);
+		__m128i cd = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, int(d.n), int(c.n)), zero);
+		__m128i rows = _mm_add_epi16(_mm_mullo_epi16(ab, _mm_set1_epi16(int16_t(256 - wy))), _mm_mullo_epi16(cd, _mm_set1_epi16(int16_t(wy))));
+		rows = _mm_srli_epi16(_mm_add_epi16(rows, half), 8);
+		__m128i cols = _mm_add_epi16(_mm_mullo_epi16(rows, _mm_set1_epi16(int16_t(256 - wx))), _mm_mullo_epi16(_mm_srli_si128(rows, 8), _mm_set1_epi16(int16_t(wx))));
+		cols = _mm_srli_epi16(_mm_add_epi16(cols, half), 8);
+		olc::Pixel p;
+		p.n = uint32_t(_mm_cvtsi128_si32(_mm_packus_epi16(cols, zero)));
+		return p;
+#else
+		uint32_t n = 0;
+		for (uint32_t s = 0; s < 32; s += 8)
+		{
+			uint32_t l = ((((a.n >> s) & 0xFF) * (256 - wy) + ((c.n >> s) & 0xFF) * wy + 128) >> 8);
+			uint32_t r = ((((b.n >> s) & 0xFF) * (256 - wy) + ((d.n >> s) & 0xFF) * wy + 128) >> 8);
+			n |= ((l * (256 - wx) + r * wx + 128) >> 8) << s;
+		}
+		olc::Pixel p;
+		p.n = n;
+		return p;
+#endif
+	}
+
+	// Bilinear samples along a row given in 32.32 fixed point texel coordinates,
+	// texel centres at whole numbers. Shared by SampleBLRow() and the CPU
+	// transformed sprite drawing, which steps from exact fixed point origins.
+	template<typename TexelFunc>
+	static void SampleBLRowFixed(const olc::Sprite* spr, olc::Pixel* pDest, uint32_t nCount, int64_t fx, int64_t fy, int64_t fdx, int64_t fdy, TexelFunc Texel)
+	{
+		const int32_t width = spr->width, height = spr->height;
+		const bool bWrap = spr->modeSample == olc::Sprite::Mode::PERIODIC;
+
+		auto texels = [&](int64_t i, int32_t nSize, int32_t& i0, int32_t& i1)
+		{
+			if (i >= 0 && i < nSize - 1) { i0 = int32_t(i); i1 = i0 + 1; }
+			else if (bWrap)
+			{
+				i0 = int32_t(((i % nSize) + nSize) % nSize);
+				i1 = i0 + 1 == nSize ? 0 : i0 + 1;
+			}
+			else
+			{
+				i0 = int32_t(std::clamp(i, int64_t(0), int64_t(nSize - 1)));
+				i1 = int32_t(std::clamp(i + 1, int64_t(0), int64_t(nSize - 1)));
+			}
+		};
+
+		for (uint32_t i = 0; i < nCount; i++, fx += fdx, fy += fdy)
+		{
+			int32_t x0, x1, y0, y1;
+			texels(fx >> 32, width, x0, x1);
+			texels(fy >> 32, height, y0, y1);
+			pDest[i] = BlendTexels(Texel(x0, y0), Texel(x1, y0), Texel(x0, y1), Texel(x1, y1), uint32_t(fx >> 24) & 0xFF, uint32_t(fy >> 24) & 0xFF);
+		}
+	}
+
+	// Picks the texel fetch once per row, packed formats unpack as they go
+	static void SampleBLRowFixed(const olc::Sprite* spr, olc::Pixel* pDest, uint32_t nCount, int64_t fx, int64_t fy, int64_t fdx, int64_t fdy)
+	{
+		const olc::Sprite::Format format = spr->GetFormat();
+		const olc::Pixel* pSrc = spr->pColData.data();
+		const size_t nWidth = size_t(spr->width);
+		const int32_t nTilesX = (spr->width + 7) >> 3;
+		if (format == olc::Sprite::Format::RGBA8 && spr->GetLayout() == olc::Sprite::Layout::LINEAR)
+			SampleBLRowFixed(spr, pDest, nCount, fx, fy, fdx, fdy, [=](int32_t x, int32_t y) { return pSrc[size_t(y) * nWidth + size_t(x)]; });
+		else if (format == olc::Sprite::Format::RGBA8)
+			SampleBLRowFixed(spr, pDest, nCount, fx, fy, fdx, fdy, [=](int32_t x, int32_t y) { return pSrc[olc::Sprite::GetTiledIndex(x, y, nTilesX)]; });
+		else
+		{
+			const uint32_t nSize = olc::Sprite::GetFormatSize(format);
+			const uint8_t* pRaw = spr->GetRawData();
+			SampleBLRowFixed(spr, pDest, nCount, fx, fy, fdx, fdy, [=](int32_t x, int32_t y) { return UnpackTexel(format, pRaw + spr->GetTexelIndex(x, y) * nSize); });
+		}
+	}
+
+	void Sprite::SampleBLRow(olc::Pixel* pDest, uint32_t nCount, const olc::vf2d& uv, const olc::vf2d& duv) const
+	{
+		if (width <= 0 || height <= 0)
+		{
+			std::fill(pDest, pDest + nCount, olc::BLANK);
+			return;
+		}
+
+		// Texel space in 32.32 fixed point, half a texel back as in SampleBL(), so
+		// stepping errors stay far below one weight step across long rows
+		const double fOne = 4294967296.0;
+		SampleBLRowFixed(this, pDest, nCount,
+			std::llround((double(uv.x) * width - 0.5) * fOne), std::llround((double(uv.y) * height - 0.5) * fOne),
+			std::llround(double(duv.x) * width * fOne), std::llround(double(duv.y) * height * fOne));
 	}
 
 	Pixel* Sprite::GetData()
@@ -1389,27 +2583,223 @@ namespace olc
 
 	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
 	{
-		UNUSED(pack);
+		format = Format::RGBA8;
+		layout = Layout::LINEAR;
+		if (pack == nullptr && !sCacheDirectory.empty())
+			return LoadFromFileCached(sImageFile);
 		return loader->LoadImageResource(this, sImageFile, pack);
 	}
 
+	void Sprite::SetFileCache(const std::string& sDirectory, olc::ResourceCodec codec)
+	{
+		sCacheDirectory = sDirectory;
+		cacheCodec = codec;
+		std::error_code ec;
+		if (!sDirectory.empty()) _gfs::create_directories(sDirectory, ec);
+	}
+
+	olc::rcode Sprite::LoadFromFileCached(const std::string& sImageFile)
+	{
+		std::error_code ec;
+		if (!_gfs::exists(sImageFile, ec)) return olc::rcode::NO_FILE;
+		const uint64_t nSourceSize = uint64_t(_gfs::file_size(sImageFile, ec));
+		const int64_t nSourceTime = int64_t(_gfs::last_write_time(sImageFile, ec).time_since_epoch().count());
+
+		std::string sKey = _gfs::absolute(sImageFile).string();
+		char sName[32];
+		std::snprintf(sName, sizeof(sName), "%016llx.pgespr", (unsigned long long)HashPGESpr(sKey.data(), sKey.size()));
+		const std::string sCacheFile = (_gfs::path(sCacheDirectory) / sName).string();
+
+		// Entry is good if the source still has the same mtime, or failing that, the
+		// same contents, e.g. after a fresh checkout touched every file
+		uint64_t nSourceHash = 0;
+		bool bHashed = false, bTouched = false;
+		auto Accept = [&](const sPGESprHeader& h)
+		{
+			if (h.nVersion != 2 || h.nSourceSize != nSourceSize) return false;
+			if (h.nSourceTime == nSourceTime) return true;
+			if (!bHashed) { nSourceHash = HashPGESprFile(sImageFile); bHashed = true; }
+			bTouched = true;
+			return h.nSourceHash == nSourceHash;
+		};
+
+		if (LoadPGESpr(this, sCacheFile, Accept) == olc::rcode::OK)
+		{
+			// Only the key in the header changes, so patch it in place
+			if (bTouched)
+			{
+				std::fstream fs(sCacheFile, std::ios::in | std::ios::out | std::ios::binary);
+				fs.seekp(offsetof(sPGESprHeader, nSourceTime));
+				fs.write((const char*)&nSourceTime, sizeof(nSourceTime));
+			}
+			return olc::rcode::OK;
+		}
+
+		olc::rcode rc = loader->LoadImageResource(this, sImageFile, nullptr);
+		if (rc != olc::rcode::OK) return rc;
+
+		sPGESprHeader h;
+		h.nSourceSize = nSourceSize;
+		h.nSourceTime = nSourceTime;
+		h.nSourceHash = bHashed ? nSourceHash : HashPGESprFile(sImageFile);
+		// Not being able to write the cache is no reason to fail the load
+		SavePGESpr(this, sCacheFile, cacheCodec, h);
+		return olc::rcode::OK;
+	}
+
 	olc::Sprite* Sprite::Duplicate()
 	{
-		olc::Sprite* spr = new olc::Sprite(width, height);
-		std::memcpy(spr->GetData(), GetData(), width * height * sizeof(olc::Pixel));
+		olc::Sprite* spr = new olc::Sprite();
+		spr->width = width; spr->height = height;
+		spr->pColData.allocate_uninitialised(pColData.size());
+		std::memcpy(spr->GetData(), GetData(), pColData.size() * sizeof(olc::Pixel));
 		spr->modeSample = modeSample;
+		spr->format = format;
+		spr->layout = layout;
 		return spr;
 	}
 
+	void Sprite::Swap(olc::Sprite& other)
+	{
+		// The sample mode is how the sprite is used rather than the image, it stays
+		std::swap(width, other.width);
+		std::swap(height, other.height);
+		std::swap(pColData, other.pColData);
+		std::swap(format, other.format);
+		std::swap(layout, other.layout);
+	}
+
 	olc::Sprite* Sprite::Duplicate(const olc::vi2d& vPos, const olc::vi2d& vSize)
 	{
-		olc::Sprite* spr = new olc::Sprite(vSize.x, vSize.y);
+		olc::Sprite* spr = new olc::Sprite(vSize.x, vSize.y, format);
+		if (format == Format::RGBA8)
+		{
+			for (int y = 0; y < vSize.y; y++)
+				for (int x = 0; x < vSize.x; x++)
+					spr->SetPixel(x, y, GetPixel(vPos.x + x, vPos.y + y));
+			return spr;
+		}
+
+		// Texels are copied as stored, olc::Pixel would round R32F
+		const uint32_t nSize = GetFormatSize(format);
 		for (int y = 0; y < vSize.y; y++)
 			for (int x = 0; x < vSize.x; x++)
-				spr->SetPixel(x, y, GetPixel(vPos.x + x, vPos.y + y));
+			{
+				int32_t sx = vPos.x + x, sy = vPos.y + y;
+				if (modeSample == Mode::PERIODIC) { sx = abs(sx % width); sy = abs(sy % height); }
+				else if (sx < 0 || sx >= width || sy < 0 || sy >= height) continue;
+				std::memcpy(spr->GetRawData() + (size_t(y) * vSize.x + x) * nSize, GetRawData() + GetTexelIndex(sx, sy) * nSize, nSize);
+			}
 		return spr;
 	}
 
+	// O------------------------------------------------------------------------------O
+	// | olc::FramePipeline IMPLEMENTATION                                            |
+	// O------------------------------------------------------------------------------O
+	void FramePipeline::Start(uint32_t nBuffers)
+	{
+		std::unique_lock<std::mutex> lock(mux);
+		vPackets.resize(nBuffers);
+		vFree.clear();
+		qReady.clear();
+		for (auto& packet : vPackets)
+		{
+			if (!packet) packet = std::make_unique<Packet>();
+			vFree.push_back(packet.get());
+		}
+		idRenderThread = std::this_thread::get_id();
+		bFinished = false;
+		bRunning = true;
+	}
+
+	void FramePipeline::Finish()
+	{
+		std::unique_lock<std::mutex> lock(mux);
+		bFinished = true;
+		cvRender.notify_one();
+	}
+
+	void FramePipeline::Stop()
+	{ bRunning = false; }
+
+	bool FramePipeline::IsRunning() const
+	{ return bRunning; }
+
+	bool FramePipeline::IsRenderThread() const
+	{ return std::this_thread::get_id() == idRenderThread; }
+
+	FramePipeline::Packet* FramePipeline::BeginPacket()
+	{
+		std::unique_lock<std::mutex> lock(mux);
+		cvUpdate.wait(lock, [&]() { return !vFree.empty(); });
+		Packet* packet = vFree.back();
+		vFree.pop_back();
+		return packet;
+	}
+
+	void FramePipeline::SubmitPacket(Packet* packet)
+	{
+		std::unique_lock<std::mutex> lock(mux);
+		qReady.push_back(packet);
+		cvRender.notify_one();
+	}
+
+	FramePipeline::Packet* FramePipeline::NextPacket(std::chrono::milliseconds nTimeout, bool& bDone)
+	{
+		auto tpTimeout = std::chrono::steady_clock::now() + nTimeout;
+		std::unique_lock<std::mutex> lock(mux);
+		while (true)
+		{
+			if (!qReady.empty())
+			{
+				Packet* packet = qReady.front();
+				qReady.pop_front();
+				return packet;
+			}
+
+			if (!qCalls.empty())
+			{
+				Call* call = qCalls.front();
+				qCalls.pop_front();
+				lock.unlock();
+				(*call->func)();
+				lock.lock();
+				call->bDone = true;
+				cvUpdate.notify_all();
+				continue;
+			}
+
+			if (bFinished)
+			{
+				bDone = true;
+				return nullptr;
+			}
+
+			if (cvRender.wait_until(lock, tpTimeout) == std::cv_status::timeout
+				&& qReady.empty() && qCalls.empty() && !bFinished)
+				return nullptr;
+		}
+	}
+
+	void FramePipeline::ReleasePacket(Packet* packet)
+	{
+		std::unique_lock<std::mutex> lock(mux);
+		vFree.push_back(packet);
+		cvUpdate.notify_all();
+	}
+
+	void FramePipeline::RunOnRenderThread(const std::function<void()>& f)
+	{
+		if (!bRunning || IsRenderThread()) { f(); return; }
+
+		Call call;
+		call.func = &f;
+		std::unique_lock<std::mutex> lock(mux);
+		qCalls.push_back(&call);
+		cvRender.notify_one();
+		cvUpdate.wait(lock, [&]() { return call.bDone; });
+	}
+
 	// O------------------------------------------------------------------------------O
 	// | olc::Decal IMPLEMENTATION                                                    |
 	// O------------------------------------------------------------------------------O
@@ -1418,8 +2808,11 @@ namespace olc
 		id = -1;
 		if (spr == nullptr) return;
 		sprite = spr;
-		id = renderer->CreateTexture(sprite->width, sprite->height, filter, clamp);
-		Update();
+		RunOnRenderThread([&]()
+		{
+			id = renderer->CreateTexture(sprite->width, sprite->height, filter, clamp);
+			Update();
+		});
 	}
 
 	Decal::Decal(const uint32_t nExistingTextureResource, olc::Sprite* spr)
@@ -1432,22 +2825,28 @@ namespace olc
 	{
 		if (sprite == nullptr) return;
 		vUVScale = { 1.0f / float(sprite->width), 1.0f / float(sprite->height) };
-		renderer->ApplyTexture(id);
-		renderer->UpdateTexture(id, sprite);
+		RunOnRenderThread([&]()
+		{
+			renderer->ApplyTexture(id);
+			renderer->UpdateTexture(id, sprite);
+		});
 	}
 
 	void Decal::UpdateSprite()
 	{
 		if (sprite == nullptr) return;
-		renderer->ApplyTexture(id);
-		renderer->ReadTexture(id, sprite);
+		RunOnRenderThread([&]()
+		{
+			renderer->ApplyTexture(id);
+			renderer->ReadTexture(id, sprite);
+		});
 	}
 
 	Decal::~Decal()
 	{
 		if (id != -1)
 		{
-			renderer->DeleteTexture(id);
+			RunOnRenderThread([&]() { renderer->DeleteTexture(id); });
 			id = -1;
 		}
 	}
@@ -1468,18 +2867,591 @@ namespace olc
 		}
 		else
 		{
-			pSprite.release();
-			pSprite = nullptr;
+			pSprite.reset();
 			return olc::rcode::NO_FILE;
 		}
 	}
 
+	uint32_t Renderable::LoadBatch(std::vector<BatchItem>& vItems, uint32_t nThreads)
+	{
+		ThreadPool pool(nThreads);
+		return LoadBatch(vItems, pool);
+	}
+
+	uint32_t Renderable::LoadBatch(std::vector<BatchItem>& vItems, ThreadPool& pool)
+	{
+		// 1) Warm up resource packs so compressed entries are decoded in parallel
+		// and the image decoders below do not queue up on the pack file
+		std::map<ResourcePack*, std::vector<std::string>> mapPackFiles;
+		for (const auto& item : vItems)
+			if (item.pack != nullptr) mapPackFiles[item.pack].push_back(item.sFile);
+		for (auto& p : mapPackFiles)
+			p.first->Preload(p.second, pool);
+
+		// 2) Decode, nothing in here may touch the renderer
+		std::vector<std::unique_ptr<olc::Sprite>> vSprites(vItems.size());
+		pool.ParallelFor(uint32_t(vItems.size()), [&](uint32_t i)
+		{
+			BatchItem& item = vItems[i];
+			auto tp1 = std::chrono::steady_clock::now();
+			auto spr = std::make_unique<olc::Sprite>();
+			item.result = spr->LoadFromFile(item.sFile, item.pack);
+			item.fDecodeTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - tp1).count();
+			if (item.result == olc::rcode::OK) vSprites[i] = std::move(spr);
+		});
+
+		// 3) Create the textures, in one go on the render thread
+		uint32_t nLoaded = 0;
+		RunOnRenderThread([&]()
+		{
+			for (size_t i = 0; i < vItems.size(); i++)
+			{
+				BatchItem& item = vItems[i];
+				if (!vSprites[i] || item.target == nullptr) continue;
+				item.target->pSprite = std::move(vSprites[i]);
+				item.target->pDecal = std::make_unique<olc::Decal>(item.target->pSprite.get(), item.filter, item.clamp);
+				nLoaded++;
+			}
+		});
+		return nLoaded;
+	}
+
 	olc::Decal* Renderable::Decal() const
 	{ return pDecal.get(); }
 
 	olc::Sprite* Renderable::Sprite() const
 	{ return pSprite.get(); }
 
+	// O------------------------------------------------------------------------------O
+	// | olc::Atlas IMPLEMENTATION                                                    |
+	// O------------------------------------------------------------------------------O
+	Atlas::Atlas(int32_t nPageSize, int32_t nPadding) : nPageSize(nPageSize), nPadding(nPadding)
+	{ }
+
+	uint32_t Atlas::Add(const std::string& sName, const olc::Sprite* spr)
+	{
+		uint32_t nIndex = uint32_t(vRegions.size());
+		vRegions.emplace_back();
+		vNames.push_back(sName);
+		mapRegions[sName] = nIndex;
+		vQueued.push_back({ nIndex, spr });
+		return nIndex;
+	}
+
+	bool Atlas::PlaceOnPage(sPage& page, int32_t w, int32_t h, olc::vi2d& vPos) const
+	{
+		// Bottom left rule, lowest resulting top edge wins, then the snuggest node
+		size_t nBest = page.vSkyline.size();
+		int32_t nBestTop = INT32_MAX, nBestWidth = INT32_MAX, nBestY = 0;
+		for (size_t i = 0; i < page.vSkyline.size(); i++)
+		{
+			if (page.vSkyline[i].x + w > page.nWidth) break;
+			int32_t y = 0;
+			int32_t nLeft = w;
+			for (size_t j = i; nLeft > 0; j++)
+			{
+				y = std::max(y, page.vSkyline[j].y);
+				nLeft -= page.vSkyline[j].w;
+			}
+			if (y + h > page.nMaxHeight) continue;
+			if (y + h < nBestTop || (y + h == nBestTop && page.vSkyline[i].w < nBestWidth))
+			{
+				nBest = i; nBestTop = y + h; nBestWidth = page.vSkyline[i].w; nBestY = y;
+			}
+		}
+		if (nBest == page.vSkyline.size()) return false;
+
+		vPos = { page.vSkyline[nBest].x, nBestY };
+		page.vSkyline.insert(page.vSkyline.begin() + nBest, { vPos.x, nBestY + h, w });
+
+		// Trim or drop the nodes now underneath the new one
+		for (size_t i = nBest + 1; i < page.vSkyline.size();)
+		{
+			sSkylineNode& n = page.vSkyline[i];
+			int32_t nOverlap = vPos.x + w - n.x;
+			if (nOverlap <= 0) break;
+			if (nOverlap >= n.w) { page.vSkyline.erase(page.vSkyline.begin() + i); continue; }
+			n.x += nOverlap; n.w -= nOverlap;
+			break;
+		}
+
+		// Merge neighbours at the same height
+		for (size_t i = 0; i + 1 < page.vSkyline.size();)
+		{
+			if (page.vSkyline[i].y == page.vSkyline[i + 1].y)
+			{
+				page.vSkyline[i].w += page.vSkyline[i + 1].w;
+				page.vSkyline.erase(page.vSkyline.begin() + i + 1);
+			}
+			else
+				i++;
+		}
+
+		page.nUsedHeight = std::max(page.nUsedHeight, nBestTop);
+		return true;
+	}
+
+	olc::rcode Atlas::Pack()
+	{
+		olc::rcode rc = olc::rcode::OK;
+
+		// Tallest first, then widest, keeps the skyline flat
+		auto Dims = [](const olc::Sprite* spr) { return spr ? olc::vi2d(spr->width, spr->height) : olc::vi2d(0, 0); };
+		std::stable_sort(vQueued.begin(), vQueued.end(), [&](const auto& a, const auto& b)
+		{
+			olc::vi2d va = Dims(a.second), vb = Dims(b.second);
+			return va.y != vb.y ? va.y > vb.y : va.x > vb.x;
+		});
+
+		// 1) Place everything
+		std::vector<olc::vi2d> vPlaced(vQueued.size());
+		std::vector<int32_t> vPageHeight(vPages.size());
+		for (size_t i = 0; i < vPages.size(); i++) vPageHeight[i] = vPages[i].pSprite ? vPages[i].pSprite->height : 0;
+
+		for (size_t q = 0; q < vQueued.size(); q++)
+		{
+			const olc::Sprite* spr = vQueued[q].second;
+			olc::DecalRegion& region = vRegions[vQueued[q].first];
+			if (spr == nullptr || spr->width <= 0 || spr->height <= 0 || spr->pColData.size() != size_t(spr->width) * size_t(spr->height)
+				|| spr->GetFormat() != olc::Sprite::Format::RGBA8 || spr->GetLayout() != olc::Sprite::Layout::LINEAR)
+			{
+				vQueued[q].second = nullptr;
+				rc = olc::rcode::FAIL;
+				continue;
+			}
+
+			int32_t w = spr->width + 2 * nPadding;
+			int32_t h = spr->height + 2 * nPadding;
+			size_t nPage = vPages.size();
+			if (w <= nPageSize && h <= nPageSize)
+			{
+				for (size_t i = 0; i < vPages.size(); i++)
+					if (PlaceOnPage(vPages[i], w, h, vPlaced[q])) { nPage = i; break; }
+			}
+
+			if (nPage == vPages.size())
+			{
+				// Oversized sprites get a page of their own size
+				sPage page;
+				page.nWidth = std::max(nPageSize, w);
+				page.nMaxHeight = std::max(nPageSize, h);
+				page.vSkyline.push_back({ 0, 0, page.nWidth });
+				vPages.push_back(std::move(page));
+				vPageHeight.push_back(0);
+				PlaceOnPage(vPages.back(), w, h, vPlaced[q]);
+			}
+
+			region.nPage = uint32_t(nPage);
+			region.vPos = olc::vf2d(vPlaced[q] + olc::vi2d(nPadding, nPadding));
+			region.vSize = { float(spr->width), float(spr->height) };
+		}
+
+		// 2) Pages only grow as tall as they are used, any that grew get new storage
+		for (size_t i = 0; i < vPages.size(); i++)
+		{
+			sPage& page = vPages[i];
+			if (page.nUsedHeight <= vPageHeight[i]) continue;
+
+			auto pSprite = std::make_unique<olc::Sprite>();
+			pSprite->width = page.nWidth;
+			pSprite->height = page.nUsedHeight;
+			pSprite->pColData.resize(size_t(page.nWidth) * size_t(page.nUsedHeight), olc::BLANK);
+			if (page.pSprite)
+				std::memcpy(pSprite->GetData(), page.pSprite->GetData(), page.pSprite->pColData.size() * sizeof(olc::Pixel));
+			page.pSprite = std::move(pSprite);
+			// Its texture is stale now, CreateDecals() makes a new one
+			page.pDecal.reset();
+		}
+
+		// 3) Copy pixels in, repeating the edges into the padding so filtered
+		// sampling never picks up a neighbour
+		for (size_t q = 0; q < vQueued.size(); q++)
+		{
+			const olc::Sprite* spr = vQueued[q].second;
+			if (spr == nullptr) continue;
+			olc::Sprite* pPage = vPages[vRegions[vQueued[q].first].nPage].pSprite.get();
+			const olc::Pixel* pSrc = spr->pColData.data();
+			for (int32_t y = -nPadding; y < spr->height + nPadding; y++)
+			{
+				const olc::Pixel* pSrcRow = pSrc + size_t(std::clamp(y, 0, spr->height - 1)) * spr->width;
+				olc::Pixel* pDst = pPage->GetData() + size_t(vPlaced[q].y + nPadding + y) * pPage->width + vPlaced[q].x;
+				std::fill(pDst, pDst + nPadding, pSrcRow[0]);
+				std::memcpy(pDst + nPadding, pSrcRow, size_t(spr->width) * sizeof(olc::Pixel));
+				std::fill(pDst + nPadding + spr->width, pDst + 2 * nPadding + spr->width, pSrcRow[spr->width - 1]);
+			}
+		}
+
+		vQueued.clear();
+		UpdateRegionUVs();
+		return rc;
+	}
+
+	void Atlas::UpdateRegionUVs()
+	{
+		for (auto& region : vRegions)
+		{
+			if (region.vSize.x <= 0.0f) continue;
+			const sPage& page = vPages[region.nPage];
+			olc::vf2d vPageSize = { float(page.pSprite->width), float(page.pSprite->height) };
+			region.decal = page.pDecal.get();
+			region.vUVPos = region.vPos / vPageSize;
+			region.vUVSize = region.vSize / vPageSize;
+		}
+	}
+
+	void Atlas::CreateDecals(bool filter, bool clamp)
+	{
+		RunOnRenderThread([&]()
+		{
+			for (auto& page : vPages)
+				if (page.pSprite) page.pDecal = std::make_unique<olc::Decal>(page.pSprite.get(), filter, clamp);
+		});
+		UpdateRegionUVs();
+	}
+
+	olc::rcode Atlas::Save(const std::string& sBaseName, olc::ResourceCodec codec, olc::ResourcePack* pack)
+	{
+		if (!vQueued.empty() && Pack() != olc::rcode::OK) return olc::rcode::FAIL;
+
+		const std::string sIndexFile = sBaseName + ".atlas";
+		std::ofstream ofs(sIndexFile);
+		if (!ofs.is_open()) return olc::rcode::FAIL;
+		ofs << "olc-atlas 1\n" << vPages.size() << " " << vRegions.size() << "\n";
+		for (size_t i = 0; i < vRegions.size(); i++)
+		{
+			const olc::DecalRegion& r = vRegions[i];
+			ofs << r.nPage << " " << int32_t(r.vPos.x) << " " << int32_t(r.vPos.y) << " "
+				<< int32_t(r.vSize.x) << " " << int32_t(r.vSize.y) << " " << vNames[i] << "\n";
+		}
+		ofs.close();
+		if (!ofs) return olc::rcode::FAIL;
+		if (pack) pack->AddFile(sIndexFile);
+
+		for (size_t i = 0; i < vPages.size(); i++)
+		{
+			const std::string sPageFile = sBaseName + "_" + std::to_string(i) + ".pgespr";
+			if (vPages[i].pSprite->SaveToPGESprFile(sPageFile, codec) != olc::rcode::OK) return olc::rcode::FAIL;
+			// Already compressed as the page asked, the pack need not try again
+			if (pack) pack->AddFile(sPageFile);
+		}
+		return olc::rcode::OK;
+	}
+
+	olc::rcode Atlas::Load(const std::string& sBaseName, olc::ResourcePack* pack)
+	{
+		vPages.clear(); vRegions.clear(); vNames.clear(); mapRegions.clear(); vQueued.clear();
+
+		auto ReadIndex = [&](std::istream& is)
+		{
+			std::string sMagic;
+			int nVersion = 0;
+			size_t nPages = 0, nRegions = 0;
+			is >> sMagic >> nVersion >> nPages >> nRegions;
+			if (!is || sMagic != "olc-atlas" || nVersion != 1) return false;
+
+			for (size_t i = 0; i < nPages; i++)
+			{
+				sPage page;
+				page.pSprite = std::make_unique<olc::Sprite>();
+				if (page.pSprite->LoadFromPGESprFile(sBaseName + "_" + std::to_string(i) + ".pgespr", pack) != olc::rcode::OK) return false;
+				// Loaded pages are treated as full, later additions open new pages
+				page.nWidth = page.pSprite->width;
+				page.nMaxHeight = page.nUsedHeight = page.pSprite->height;
+				page.vSkyline.push_back({ 0, page.nMaxHeight, page.nWidth });
+				vPages.push_back(std::move(page));
+			}
+
+			for (size_t i = 0; i < nRegions; i++)
+			{
+				olc::DecalRegion r;
+				int32_t x, y, w, h;
+				std::string sName;
+				is >> r.nPage >> x >> y >> w >> h;
+				std::getline(is >> std::ws, sName);
+				if (!is || (w > 0 && r.nPage >= nPages)) return false;
+				r.vPos = { float(x), float(y) };
+				r.vSize = { float(w), float(h) };
+				mapRegions[sName] = uint32_t(vRegions.size());
+				vRegions.push_back(r);
+				vNames.push_back(sName);
+			}
+			return true;
+		};
+
+		bool bOk = false;
+		const std::string sIndexFile = sBaseName + ".atlas";
+		if (pack == nullptr)
+		{
+			std::ifstream ifs(sIndexFile);
+			if (!ifs.is_open()) return olc::rcode::NO_FILE;
+			bOk = ReadIndex(ifs);
+		}
+		else
+		{
+			ResourceBuffer rb = pack->GetFileBuffer(sIndexFile);
+			std::istream is(&rb);
+			bOk = ReadIndex(is);
+		}
+
+		if (!bOk)
+		{
+			vPages.clear(); vRegions.clear(); vNames.clear(); mapRegions.clear();
+			return olc::rcode::FAIL;
+		}
+		UpdateRegionUVs();
+		return olc::rcode::OK;
+	}
+
+	const olc::DecalRegion& Atlas::Region(uint32_t nIndex) const
+	{ return vRegions[nIndex]; }
+
+	const olc::DecalRegion* Atlas::Region(const std::string& sName) const
+	{
+		auto it = mapRegions.find(sName);
+		return it == mapRegions.end() ? nullptr : &vRegions[it->second];
+	}
+
+	size_t Atlas::RegionCount() const
+	{ return vRegions.size(); }
+
+	size_t Atlas::PageCount() const
+	{ return vPages.size(); }
+
+	olc::Sprite* Atlas::PageSprite(size_t nPage) const
+	{ return vPages[nPage].pSprite.get(); }
+
+	olc::Decal* Atlas::PageDecal(size_t nPage) const
+	{ return vPages[nPage].pDecal.get(); }
+
+	// O------------------------------------------------------------------------------O
+	// | olc::ThreadPool IMPLEMENTATION                                               |
+	// O------------------------------------------------------------------------------O
+	ThreadPool::ThreadPool(uint32_t nThreads)
+	{
+		if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (uint32_t i = 0; i < nThreads; i++)
+			vWorkers.emplace_back(&ThreadPool::WorkerThread, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mtxJobs);
+			bStop = true;
+		}
+		cvJob.notify_all();
+		for (auto& t : vWorkers) t.join();
+	}
+
+	void ThreadPool::Enqueue(std::function<void()> job)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mtxJobs);
+			qJobs.push(std::move(job));
+		}
+		cvJob.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock<std::mutex> lock(mtxJobs);
+		cvIdle.wait(lock, [this] { return qJobs.empty() && nBusy == 0; });
+	}
+
+	void ThreadPool::ParallelFor(uint32_t nCount, const std::function<void(uint32_t)>& func)
+	{
+		if (nCount == 0) return;
+
+		// Every participant pulls the next index until they run dry, so uneven
+		// job sizes balance out. Completion is tracked locally which keeps this
+		// independent of any other work sitting in the queue.
+		std::atomic<uint32_t> nNext{ 0 };
+		std::mutex mtxDone;
+		std::condition_variable cvDone;
+		uint32_t nHelpers = std::min(Size(), nCount - 1);
+		uint32_t nRunning = nHelpers;
+
+		auto run = [&]()
+		{
+			for (uint32_t i = nNext++; i < nCount; i = nNext++)
+				func(i);
+		};
+
+		for (uint32_t i = 0; i < nHelpers; i++)
+			Enqueue([&]()
+			{
+				run();
+				std::unique_lock<std::mutex> lock(mtxDone);
+				if (--nRunning == 0) cvDone.notify_one();
+			});
+
+		run();
+		std::unique_lock<std::mutex> lock(mtxDone);
+		cvDone.wait(lock, [&] { return nRunning == 0; });
+	}
+
+	uint32_t ThreadPool::Size() const
+	{ return uint32_t(vWorkers.size()); }
+
+	void ThreadPool::WorkerThread()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mtxJobs);
+				cvJob.wait(lock, [this] { return bStop || !qJobs.empty(); });
+				if (bStop && qJobs.empty()) return;
+				job = std::move(qJobs.front());
+				qJobs.pop();
+				nBusy++;
+			}
+
+			job();
+
+			{
+				std::unique_lock<std::mutex> lock(mtxJobs);
+				nBusy--;
+				if (qJobs.empty() && nBusy == 0) cvIdle.notify_all();
+			}
+		}
+	}
+
+	// O------------------------------------------------------------------------------O
+	// | olc::LZCodec IMPLEMENTATION                                                  |
+	// O------------------------------------------------------------------------------O
+	size_t LZCodec::Bound(size_t nSize)
+	{ return nSize + nSize / 255 + 16; }
+
+	size_t LZCodec::Compress(const uint8_t* src, size_t nSrcSize, uint8_t* dst, size_t nDstCapacity)
+	{
+		// Block format: [token][literal length+][literals][offset16][match length+]
+		// Last 5 bytes are always literals, and no match starts in the last 12
+		constexpr size_t nMinMatch = 4;
+		constexpr size_t nLastLiterals = 5;
+		constexpr size_t nMatchStartLimit = 12;
+		constexpr uint32_t nHashBits = 12;
+
+		size_t op = 0;
+		auto putLength = [&](size_t n) -> bool
+		{
+			for (; n >= 255; n -= 255) { if (op >= nDstCapacity) return false; dst[op++] = 255; }
+			if (op >= nDstCapacity) return false;
+			dst[op++] = uint8_t(n);
+			return true;
+		};
+
+		auto putSequence = [&](size_t nAnchor, size_t nLiterals, size_t nOffset, size_t nMatch) -> bool
+		{
+			if (op >= nDstCapacity) return false;
+			size_t nToken = op++;
+			dst[nToken] = uint8_t(std::min<size_t>(nLiterals, 15) << 4);
+			if (nLiterals >= 15 && !putLength(nLiterals - 15)) return false;
+			if (op + nLiterals > nDstCapacity) return false;
+			std::memcpy(dst + op, src + nAnchor, nLiterals);
+			op += nLiterals;
+			if (nMatch == 0) return true; // Final literal run
+
+			if (op + 2 > nDstCapacity) return false;
+			dst[op++] = uint8_t(nOffset & 0xFF);
+			dst[op++] = uint8_t(nOffset >> 8);
+			nMatch -= nMinMatch;
+			dst[nToken] |= uint8_t(std::min<size_t>(nMatch, 15));
+			if (nMatch >= 15 && !putLength(nMatch - 15)) return false;
+			return true;
+		};
+
+		auto read32 = [src](size_t i) { uint32_t v; std::memcpy(&v, src + i, 4); return v; };
+
+		size_t ip = 0, anchor = 0;
+		if (nSrcSize > nMatchStartLimit)
+		{
+			std::vector<uint32_t> vTable(size_t(1) << nHashBits, 0);
+			const size_t nLimit = nSrcSize - nMatchStartLimit;
+			const size_t nMatchLimit = nSrcSize - nLastLiterals;
+			while (ip < nLimit)
+			{
+				uint32_t seq = read32(ip);
+				uint32_t h = (seq * 2654435761u) >> (32 - nHashBits);
+				size_t ref = vTable[h];
+				vTable[h] = uint32_t(ip);
+
+				if (ref < ip && ip - ref <= 0xFFFF && read32(ref) == seq)
+				{
+					// Grow the match backwards into pending literals, then forwards
+					while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) { ip--; ref--; }
+					size_t nLen = nMinMatch;
+					while (ip + nLen < nMatchLimit && src[ref + nLen] == src[ip + nLen]) nLen++;
+
+					if (!putSequence(anchor, ip - anchor, ip - ref, nLen)) return 0;
+					ip += nLen;
+					anchor = ip;
+				}
+				else
+					ip++;
+			}
+		}
+
+		if (!putSequence(anchor, nSrcSize - anchor, 0, 0)) return 0;
+		return op;
+	}
+
+	bool LZCodec::Decompress(const uint8_t* src, size_t nSrcSize, uint8_t* dst, size_t nDstSize)
+	{
+		size_t ip = 0, op = 0;
+		auto getLength = [&](size_t& n) -> bool
+		{
+			uint8_t b = 0;
+			do
+			{
+				if (ip >= nSrcSize) return false;
+				b = src[ip++];
+				n += b;
+			} while (b == 255);
+			return true;
+		};
+
+		while (ip < nSrcSize)
+		{
+			uint8_t nToken = src[ip++];
+			size_t nLiterals = nToken >> 4;
+			if (nLiterals == 15 && !getLength(nLiterals)) return false;
+			if (nLiterals > nSrcSize - ip || nLiterals > nDstSize - op) return false;
+			std::memcpy(dst + op, src + ip, nLiterals);
+			ip += nLiterals; op += nLiterals;
+			if (ip == nSrcSize) break; // Final literal run has no match
+
+			if (nSrcSize - ip < 2) return false;
+			size_t nOffset = size_t(src[ip]) | (size_t(src[ip + 1]) << 8);
+			ip += 2;
+			if (nOffset == 0 || nOffset > op) return false;
+
+			size_t nMatch = nToken & 15;
+			if (nMatch == 15 && !getLength(nMatch)) return false;
+			nMatch += 4;
+			if (nMatch > nDstSize - op) return false;
+
+			uint8_t* d = dst + op;
+			if (nOffset >= nMatch)
+				std::memcpy(d, d - nOffset, nMatch);
+			else
+			{
+				// Overlapping match repeats the last nOffset bytes. Copy it in
+				// growing chunks of whole periods so no copy overlaps itself.
+				size_t nDone = 0, nSpan = nOffset;
+				while (nDone < nMatch)
+				{
+					size_t n = std::min(nSpan, nMatch - nDone);
+					std::memcpy(d + nDone, d + nDone - nSpan, n);
+					nDone += n;
+					while (nSpan * 2 <= nDone + nOffset) nSpan *= 2;
+				}
+			}
+			op += nMatch;
+		}
+		return op == nDstSize;
+	}
+
 	// O------------------------------------------------------------------------------O
 	// | olc::ResourcePack IMPLEMENTATION                                             |
 	// O------------------------------------------------------------------------------O
@@ -1488,17 +3460,46 @@ namespace olc
 	//=============================================================
 	// Resource Packs - Allows you to store files in one large 
 	// scrambled file - Thanks MaGetzUb for debugging a null char in std::stringstream bug
+	//
+	// Pack layout, all values little endian uint32_t:
+	//   [magic "OLCR"][version][index size][scrambled index][entry data...]
+	//   index: [entries] { [path size][path][size][offset][stored size][codec] }
+	// Packs without the magic are the original layout where the file starts
+	// with the index size and entries only have [size][offset], always raw.
+	constexpr uint32_t nResourcePackMagic = 0x52434C4F; // "OLCR"
+	constexpr uint32_t nResourcePackVersion = 2;
+
 	ResourceBuffer::ResourceBuffer(std::ifstream& ifs, uint32_t offset, uint32_t size)
+		: ResourceBuffer(ifs, offset, size, size, ResourceCodec::RAW)
+	{ }
+
+	ResourceBuffer::ResourceBuffer(std::ifstream& ifs, uint32_t offset, uint32_t size, uint32_t stored, ResourceCodec codec)
 	{
 		vMemory.resize(size);
-		ifs.seekg(offset); ifs.read(vMemory.data(), vMemory.size());
-		setg(vMemory.data(), vMemory.data(), vMemory.data() + size);
+		ifs.seekg(offset);
+		if (codec == ResourceCodec::LZ)
+		{
+			// Only the compressed bytes are staged, decoding lands directly
+			// in the memory that backs this stream
+			std::vector<char> vStored(stored);
+			ifs.read(vStored.data(), stored);
+			if (!LZCodec::Decompress((const uint8_t*)vStored.data(), stored, (uint8_t*)vMemory.data(), size))
+				vMemory.clear();
+		}
+		else
+			ifs.read(vMemory.data(), vMemory.size());
+		setg(vMemory.data(), vMemory.data(), vMemory.data() + vMemory.size());
+	}
+
+	ResourceBuffer::ResourceBuffer(std::vector<char>&& data) : vMemory(std::move(data))
+	{
+		setg(vMemory.data(), vMemory.data(), vMemory.data() + vMemory.size());
 	}
 
 	ResourcePack::ResourcePack() { }
 	ResourcePack::~ResourcePack() { baseFile.close(); }
 
-	bool ResourcePack::AddFile(const std::string& sFile)
+	bool ResourcePack::AddFile(const std::string& sFile, ResourceCodec codec)
 	{
 		const std::string file = makeposix(sFile);
 
@@ -1507,6 +3508,8 @@ namespace olc
 			sResourceFile e;
 			e.nSize = (uint32_t)_gfs::file_size(file);
 			e.nOffset = 0; // Unknown at this stage			
+			e.nStored = e.nSize;
+			e.nCodec = codec; // Requested codec, SavePack() decides if it is used
 			mapFiles[file] = e;
 			return true;
 		}
@@ -1519,9 +3522,16 @@ namespace olc
 		baseFile.open(sFile, std::ifstream::binary);
 		if (!baseFile.is_open()) return false;
 
-		// 1) Read Scrambled index
+		// 1) Read Scrambled index, legacy packs start directly with its size
 		uint32_t nIndexSize = 0;
+		uint32_t nVersion = 1;
 		baseFile.read((char*)&nIndexSize, sizeof(uint32_t));
+		if (nIndexSize == nResourcePackMagic)
+		{
+			baseFile.read((char*)&nVersion, sizeof(uint32_t));
+			baseFile.read((char*)&nIndexSize, sizeof(uint32_t));
+			if (nVersion > nResourcePackVersion) { baseFile.close(); return false; }
+		}
 
 		std::vector<char> buffer(nIndexSize);
 		for (uint32_t j = 0; j < nIndexSize; j++)
@@ -1551,6 +3561,12 @@ namespace olc
 			sResourceFile e;
 			read((char*)&e.nSize, sizeof(uint32_t));
 			read((char*)&e.nOffset, sizeof(uint32_t));
+			e.nStored = e.nSize;
+			if (nVersion >= 2)
+			{
+				read((char*)&e.nStored, sizeof(uint32_t));
+				read((char*)&e.nCodec, sizeof(uint32_t));
+			}
 			mapFiles[sFileName] = e;
 		}
 
@@ -1567,6 +3583,8 @@ namespace olc
 
 		// Iterate through map
 		uint32_t nIndexSize = 0; // Unknown for now
+		ofs.write((const char*)&nResourcePackMagic, sizeof(uint32_t));
+		ofs.write((const char*)&nResourcePackVersion, sizeof(uint32_t));
 		ofs.write((char*)&nIndexSize, sizeof(uint32_t));
 		uint32_t nMapSize = uint32_t(mapFiles.size());
 		ofs.write((char*)&nMapSize, sizeof(uint32_t));
@@ -1580,6 +3598,8 @@ namespace olc
 			// Write the file entry properties
 			ofs.write((char*)&e.second.nSize, sizeof(uint32_t));
 			ofs.write((char*)&e.second.nOffset, sizeof(uint32_t));
+			ofs.write((char*)&e.second.nStored, sizeof(uint32_t));
+			ofs.write((char*)&e.second.nCodec, sizeof(uint32_t));
 		}
 
 		// 2) Write the individual Data
@@ -1596,9 +3616,26 @@ namespace olc
 			i.read((char*)vBuffer.data(), e.second.nSize);
 			i.close();
 
+			// Compress if asked to, but keep it raw when that does not pay off
+			const uint8_t* pData = vBuffer.data();
+			e.second.nStored = e.second.nSize;
+			std::vector<uint8_t> vPacked;
+			if (e.second.nCodec == ResourceCodec::LZ)
+			{
+				vPacked.resize(LZCodec::Bound(e.second.nSize));
+				size_t nPacked = LZCodec::Compress(vBuffer.data(), vBuffer.size(), vPacked.data(), vPacked.size());
+				if (nPacked > 0 && nPacked < e.second.nSize)
+				{
+					pData = vPacked.data();
+					e.second.nStored = uint32_t(nPacked);
+				}
+				else
+					e.second.nCodec = ResourceCodec::RAW;
+			}
+
 			// Write the loaded file into resource pack file
-			ofs.write((char*)vBuffer.data(), e.second.nSize);
-			offset += e.second.nSize;
+			ofs.write((const char*)pData, e.second.nStored);
+			offset += e.second.nStored;
 		}
 
 		// 3) Scramble Index
@@ -1621,12 +3658,14 @@ namespace olc
 			// Write the file entry properties
 			write((char*)&e.second.nSize, sizeof(uint32_t));
 			write((char*)&e.second.nOffset, sizeof(uint32_t));
+			write((char*)&e.second.nStored, sizeof(uint32_t));
+			write((char*)&e.second.nCodec, sizeof(uint32_t));
 		}
 		std::vector<char> sIndexString = scramble(stream, sKey);
 		uint32_t nIndexStringLen = uint32_t(sIndexString.size());
 		// 4) Rewrite Map (it has been updated with offsets now)
-		// at start of file
-		ofs.seekp(0, std::ios::beg);
+		// at start of file, just after the magic and version
+		ofs.seekp(2 * sizeof(uint32_t), std::ios::beg);
 		ofs.write((char*)&nIndexStringLen, sizeof(uint32_t));
 		ofs.write(sIndexString.data(), nIndexStringLen);
 		ofs.close();
@@ -1634,7 +3673,90 @@ namespace olc
 	}
 
 	ResourceBuffer ResourcePack::GetFileBuffer(const std::string& sFile)
-	{ return ResourceBuffer(baseFile, mapFiles[sFile].nOffset, mapFiles[sFile].nSize); }
+	{
+		std::unique_lock<std::mutex> lock(mtxPack);
+		auto pre = mapPreloaded.find(sFile);
+		if (pre != mapPreloaded.end())
+		{
+			std::vector<char> vData = std::move(pre->second);
+			mapPreloaded.erase(pre);
+			return ResourceBuffer(std::move(vData));
+		}
+
+		// Unknown files give an empty buffer, without growing the map
+		auto it = mapFiles.find(sFile);
+		if (it == mapFiles.end()) return ResourceBuffer(std::vector<char>());
+		const sResourceFile& e = it->second;
+		return ResourceBuffer(baseFile, e.nOffset, e.nSize, e.nStored, e.nCodec);
+	}
+
+	uint32_t ResourcePack::Preload(const std::vector<std::string>& vFiles, uint32_t nThreads)
+	{
+		ThreadPool pool(nThreads);
+		return Preload(vFiles, pool);
+	}
+
+	uint32_t ResourcePack::Preload(const std::vector<std::string>& vFiles, ThreadPool& pool)
+	{
+		std::unique_lock<std::mutex> lock(mtxPack);
+		if (!baseFile.is_open()) return 0;
+
+		struct sPreload
+		{
+			const std::string* sName;
+			sResourceFile e;
+			std::vector<char> vStored;
+			std::vector<char> vData;
+			bool bOK = true;
+		};
+
+		std::vector<sPreload> vJobs;
+		for (const auto& f : vFiles)
+		{
+			auto it = mapFiles.find(f);
+			if (it == mapFiles.end() || mapPreloaded.count(f)) continue;
+			sPreload p;
+			p.sName = &it->first;
+			p.e = it->second;
+			vJobs.push_back(std::move(p));
+		}
+
+		// 1) Pull the stored bytes off disk in file order, there is only one
+		// stream so this part stays serial. Raw entries go straight to their
+		// destination, compressed ones are staged for decoding.
+		std::sort(vJobs.begin(), vJobs.end(), [](const sPreload& a, const sPreload& b) { return a.e.nOffset < b.e.nOffset; });
+		for (auto& p : vJobs)
+		{
+			std::vector<char>& vTarget = (p.e.nCodec == ResourceCodec::LZ) ? p.vStored : p.vData;
+			vTarget.resize(p.e.nCodec == ResourceCodec::LZ ? p.e.nStored : p.e.nSize);
+			baseFile.seekg(p.e.nOffset);
+			baseFile.read(vTarget.data(), vTarget.size());
+			p.bOK = bool(baseFile);
+			baseFile.clear();
+		}
+		lock.unlock();
+
+		// 2) Decode in parallel, each job writes only its own destination
+		pool.ParallelFor(uint32_t(vJobs.size()), [&vJobs](uint32_t i)
+		{
+			sPreload& p = vJobs[i];
+			if (!p.bOK || p.e.nCodec != ResourceCodec::LZ) return;
+			p.vData.resize(p.e.nSize);
+			p.bOK = LZCodec::Decompress((const uint8_t*)p.vStored.data(), p.vStored.size(), (uint8_t*)p.vData.data(), p.vData.size());
+			p.vStored = std::vector<char>();
+		});
+
+		// 3) Publish
+		lock.lock();
+		uint32_t nLoaded = 0;
+		for (auto& p : vJobs)
+		{
+			if (!p.bOK) continue;
+			mapPreloaded[*p.sName] = std::move(p.vData);
+			nLoaded++;
+		}
+		return nLoaded;
+	}
 
 	bool ResourcePack::Loaded()
 	{ return baseFile.is_open(); }
@@ -1655,6 +3777,206 @@ namespace olc
 		return o;
 	};
 
+	// O------------------------------------------------------------------------------O
+	// | olc::SessionLog IMPLEMENTATION                                               |
+	// O------------------------------------------------------------------------------O
+	// "olcS", a version byte and the screen size, then the frames. Each frame is
+	// its time, a byte of flags for what changed, and then for each flag set:
+	//   1  input     count, then each event as code << 2 | mouse << 1 | pressed
+	//   2  position  signed change in x and y
+	//   4  wheel     signed delta
+	//   8  focus     input focus in bit 0, mouse focus in bit 1
+	// All numbers are varints, signed ones zigzag encoded.
+	static const char sSessionMagic[4] = { 'o', 'l', 'c', 'S' };
+	static const uint8_t nSessionVersion = 2;
+
+	olc::rcode SessionLog::OpenWrite(const std::string& sFile, const olc::vi2d& vSize)
+	{
+		Close();
+		file.open(sFile, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) return olc::FAIL;
+		vScreenSize = vSize;
+		last = SessionFrame();
+		vBuffer.assign(sSessionMagic, sSessionMagic + 4);
+		vBuffer.push_back(nSessionVersion);
+		PutVarint(uint64_t(vSize.x));
+		PutVarint(uint64_t(vSize.y));
+		file.write((const char*)vBuffer.data(), vBuffer.size());
+		return file.good() ? olc::OK : olc::FAIL;
+	}
+
+	olc::rcode SessionLog::OpenRead(const std::string& sFile)
+	{
+		Close();
+		file.open(sFile, std::ios::in | std::ios::binary);
+		if (!file.is_open()) return olc::FAIL;
+		last = SessionFrame();
+		char sMagic[4] = { 0 };
+		uint64_t w = 0, h = 0;
+		file.read(sMagic, 4);
+		if (!file.good() || !std::equal(sMagic, sMagic + 4, sSessionMagic) || file.get() != nSessionVersion
+			|| !GetVarint(w) || !GetVarint(h))
+		{
+			Close();
+			return olc::FAIL;
+		}
+		vScreenSize = { int32_t(w), int32_t(h) };
+		return olc::OK;
+	}
+
+	void SessionLog::Close()
+	{ if (file.is_open()) file.close(); file.clear(); }
+
+	bool SessionLog::IsOpen() const
+	{ return file.is_open(); }
+
+	const olc::vi2d& SessionLog::GetScreenSize() const
+	{ return vScreenSize; }
+
+	void SessionLog::PutVarint(uint64_t n)
+	{
+		while (n >= 0x80) { vBuffer.push_back(uint8_t(n) | 0x80); n >>= 7; }
+		vBuffer.push_back(uint8_t(n));
+	}
+
+	bool SessionLog::GetVarint(uint64_t& n)
+	{
+		n = 0;
+		for (int nShift = 0; nShift < 64; nShift += 7)
+		{
+			const int c = file.get();
+			if (c == std::char_traits<char>::eof()) return false;
+			n |= uint64_t(c & 0x7F) << nShift;
+			if (!(c & 0x80)) return true;
+		}
+		return false;
+	}
+
+	void SessionLog::Write(const SessionFrame& frame)
+	{
+		vBuffer.clear();
+		PutVarint(uint64_t(std::max(frame.nFrameTimeNs, int64_t(0))));
+		const size_t nFlagsAt = vBuffer.size();
+		uint8_t nFlags = 0;
+		vBuffer.push_back(0);
+
+		if (!frame.vInput.empty())
+		{
+			nFlags |= 1;
+			PutVarint(frame.vInput.size());
+			for (const auto& e : frame.vInput)
+				PutVarint(uint64_t(e.nCode) << 2 | uint64_t(e.device == InputEvent::Device::MOUSE) << 1 | uint64_t(e.bPressed));
+		}
+
+		if (frame.vMousePos != last.vMousePos)
+		{
+			nFlags |= 2;
+			PutVarint(ZigZag(int64_t(frame.vMousePos.x) - last.vMousePos.x));
+			PutVarint(ZigZag(int64_t(frame.vMousePos.y) - last.vMousePos.y));
+		}
+
+		if (frame.nMouseWheelDelta != 0) { nFlags |= 4; PutVarint(ZigZag(frame.nMouseWheelDelta)); }
+
+		const uint8_t nFocus = uint8_t(frame.bInputFocus) | uint8_t(frame.bMouseFocus) << 1;
+		if (nFocus != (uint8_t(last.bInputFocus) | uint8_t(last.bMouseFocus) << 1)) { nFlags |= 8; vBuffer.push_back(nFocus); }
+
+		vBuffer[nFlagsAt] = nFlags;
+		file.write((const char*)vBuffer.data(), vBuffer.size());
+		last = frame;
+	}
+
+	bool SessionLog::Read(SessionFrame& frame)
+	{
+		uint64_t n = 0;
+		if (!file.is_open() || !GetVarint(n)) return false;
+		frame.vInput.clear();
+		frame.nFrameTimeNs = int64_t(n);
+		frame.vMousePos = last.vMousePos;
+		frame.nMouseWheelDelta = 0;
+		frame.bInputFocus = last.bInputFocus;
+		frame.bMouseFocus = last.bMouseFocus;
+
+		const int nFlags = file.get();
+		if (nFlags == std::char_traits<char>::eof()) return false;
+
+		if (nFlags & 1)
+		{
+			uint64_t nEvents = 0, e = 0;
+			if (!GetVarint(nEvents) || nEvents > 256 + nMouseButtons) return false;
+			for (uint64_t i = 0; i < nEvents; i++)
+			{
+				if (!GetVarint(e)) return false;
+				const bool bMouse = (e >> 1) & 1;
+				const uint32_t nCode = uint32_t(e >> 2);
+				if (nCode >= (bMouse ? uint32_t(nMouseButtons) : 256u)) return false;
+				frame.vInput.push_back({ bMouse ? InputEvent::Device::MOUSE : InputEvent::Device::KEYBOARD, nCode, bool(e & 1) });
+			}
+		}
+
+		if (nFlags & 2)
+		{
+			uint64_t dx = 0, dy = 0;
+			if (!GetVarint(dx) || !GetVarint(dy)) return false;
+			frame.vMousePos.x += int32_t(UnZigZag(dx));
+			frame.vMousePos.y += int32_t(UnZigZag(dy));
+		}
+
+		if (nFlags & 4)
+		{
+			if (!GetVarint(n)) return false;
+			frame.nMouseWheelDelta = int32_t(UnZigZag(n));
+		}
+
+		if (nFlags & 8)
+		{
+			const int nFocus = file.get();
+			if (nFocus == std::char_traits<char>::eof()) return false;
+			frame.bInputFocus = nFocus & 1;
+			frame.bMouseFocus = (nFocus >> 1) & 1;
+		}
+
+		last = frame;
+		return true;
+	}
+
+	// Stand in for the platform and renderer when running headless, nothing is shown
+	class Platform_Headless : public olc::Platform
+	{
+	public:
+		olc::rcode ApplicationStartUp() override { return olc::OK; }
+		olc::rcode ApplicationCleanUp() override { return olc::OK; }
+		olc::rcode ThreadStartUp() override { return olc::OK; }
+		olc::rcode ThreadCleanUp() override { return olc::OK; }
+		olc::rcode CreateGraphics(bool, bool, const olc::vi2d&, const olc::vi2d&) override { return olc::OK; }
+		olc::rcode CreateWindowPane(const olc::vi2d&, olc::vi2d&, bool) override { return olc::OK; }
+		olc::rcode SetWindowTitle(const std::string&) override { return olc::OK; }
+		olc::rcode StartSystemEventLoop() override { return olc::OK; }
+		olc::rcode HandleSystemEvent() override { return olc::OK; }
+	};
+
+	class Renderer_Headless : public olc::Renderer
+	{
+	public:
+		void PrepareDevice() override {}
+		olc::rcode CreateDevice(std::vector<void*>, bool, bool) override { return olc::OK; }
+		olc::rcode DestroyDevice() override { return olc::OK; }
+		void DisplayFrame() override {}
+		void PrepareDrawing() override {}
+		void SetDecalMode(const olc::DecalMode&) override {}
+		void DrawLayerQuad(const olc::vf2d&, const olc::vf2d&, const olc::Pixel) override {}
+		void DrawDecal(const olc::DecalInstance&) override {}
+		uint32_t CreateTexture(const uint32_t, const uint32_t, const bool, const bool) override { return ++nTextures; }
+		void UpdateTexture(uint32_t, olc::Sprite*) override {}
+		void ReadTexture(uint32_t, olc::Sprite*) override {}
+		uint32_t DeleteTexture(const uint32_t id) override { return id; }
+		void ApplyTexture(uint32_t) override {}
+		void UpdateViewport(const olc::vi2d&, const olc::vi2d&) override {}
+		void ClearBuffer(olc::Pixel, bool) override {}
+
+	private:
+		uint32_t nTextures = 0;
+	};
+
 	// O------------------------------------------------------------------------------O
 	// | olc::PixelGameEngine IMPLEMENTATION                                          |
 	// O------------------------------------------------------------------------------O
@@ -1689,23 +4011,94 @@ namespace olc
 	}
 
 
-	void PixelGameEngine::SetScreenSize(int w, int h)
+	void PixelGameEngine::SetScreenSize(int w, int h)
+	{
+		FlushDeferred();
+		{
+			// The platform maps the mouse with it
+			std::lock_guard<std::mutex> lock(muxInput);
+			vScreenSize = { w, h };
+		}
+		vInvScreenSize = { 1.0f / float(w), 1.0f / float(h) };
+		for (auto& layer : vLayers)
+		{
+			delete layer.pDrawTarget; // Erase existing layer sprites
+			layer.pDrawTarget = new Sprite(vScreenSize.x, vScreenSize.y);
+			layer.bUpdate = true;
+		}
+		SetDrawTarget(nullptr);
+		RunOnRenderThread([&]()
+		{
+			renderer->ClearBuffer(olc::BLACK, true);
+			renderer->DisplayFrame();
+			renderer->ClearBuffer(olc::BLACK, true);
+			renderer->UpdateViewport(vViewPos, vViewSize);
+		});
+	}
+
+	olc::rcode PixelGameEngine::Replay(const std::string& sFile, std::vector<int64_t>& vUpdateNs)
+	{
+		olc::SessionLog log;
+		if (log.OpenRead(sFile) != olc::OK || log.GetScreenSize() != vScreenSize) return olc::FAIL;
+
+		olc_PrepareHeadless();
+
+		// Frames follow each other as fast as they can, frame rate limits and
+		// idle rates only apply to the recorded frame times
+		olc::SessionFrame frame;
+		vUpdateNs.clear();
+		while (bAtomActive && log.Read(frame))
+		{
+			pReplayFrame = &frame;
+			auto tp = std::chrono::steady_clock::now();
+			olc_UpdateFrame();
+			vUpdateNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp).count());
+			olc_RenderFrame(vLayers);
+			sPendingTitle.clear();
+		}
+		pReplayFrame = nullptr;
+
+		OnUserDestroy();
+		platform->ThreadCleanUp();
+		return olc::OK;
+	}
+
+	olc::rcode PixelGameEngine::StartHeadless()
+	{
+		olc_PrepareHeadless();
+
+		// Frame rate limits still apply, as they would with a window
+		while (bAtomActive) { olc_CoreUpdate(); olc_PaceFrame(); }
+
+		OnUserDestroy();
+		StopRecording();
+		platform->ThreadCleanUp();
+		return olc::OK;
+	}
+
+	void PixelGameEngine::olc_PrepareHeadless()
+	{
+		platform = std::make_unique<olc::Platform_Headless>();
+		renderer = std::make_unique<olc::Renderer_Headless>();
+
+		bAtomActive = true;
+		olc_PrepareEngine();
+		for (auto& ext : vExtensions) ext->OnBeforeUserCreate();
+		if (!OnUserCreate()) bAtomActive = false;
+		for (auto& ext : vExtensions) ext->OnAfterUserCreate();
+	}
+
+	olc::rcode PixelGameEngine::StartRecording(const std::string& sFile)
 	{
-		vScreenSize = { w, h };
-		vInvScreenSize = { 1.0f / float(w), 1.0f / float(h) };
-		for (auto& layer : vLayers)
-		{
-			delete layer.pDrawTarget; // Erase existing layer sprites
-			layer.pDrawTarget = new Sprite(vScreenSize.x, vScreenSize.y);
-			layer.bUpdate = true;
-		}
-		SetDrawTarget(nullptr);
-		renderer->ClearBuffer(olc::BLACK, true);
-		renderer->DisplayFrame();
-		renderer->ClearBuffer(olc::BLACK, true);
-		renderer->UpdateViewport(vViewPos, vViewSize);
+		auto log = std::make_unique<olc::SessionLog>();
+		if (log->OpenWrite(sFile, vScreenSize) != olc::OK) return olc::FAIL;
+		pRecording = std::move(log);
+		return olc::OK;
 	}
 
+	void PixelGameEngine::StopRecording()
+	{ pRecording.reset(); }
+
 #if !defined(PGE_USE_CUSTOM_START)
 	olc::rcode PixelGameEngine::Start()
 	{
@@ -1733,6 +4126,12 @@ namespace olc
 
 	void PixelGameEngine::SetDrawTarget(Sprite* target)
 	{
+		// The drawing routines write olc::Pixels row by row, other formats have
+		// fewer bytes per texel and would be written past their end, and tiles
+		// would be scrambled
+		if (target && (target->GetFormat() != olc::Sprite::Format::RGBA8 ||
+			target->GetLayout() != olc::Sprite::Layout::LINEAR)) return;
+		FlushDeferred();
 		if (target)
 		{
 			pDrawTarget = target;
@@ -1746,6 +4145,7 @@ namespace olc
 
 	void PixelGameEngine::SetDrawTarget(uint8_t layer)
 	{
+		FlushDeferred();
 		if (layer < vLayers.size())
 		{
 			pDrawTarget = vLayers[layer].pDrawTarget;
@@ -1775,6 +4175,9 @@ namespace olc
 	void PixelGameEngine::SetLayerCustomRenderFunction(uint8_t layer, std::function<void()> f)
 	{ if (layer < vLayers.size()) vLayers[layer].funcHook = f; }
 
+	void PixelGameEngine::EnableDecalSorting(uint8_t layer, bool b)
+	{ if (layer < vLayers.size()) vLayers[layer].bSortDecals = b; }
+
 	std::vector<LayerDesc>& PixelGameEngine::GetLayers()
 	{ return vLayers; }
 
@@ -1782,8 +4185,11 @@ namespace olc
 	{
 		LayerDesc ld;
 		ld.pDrawTarget = new olc::Sprite(vScreenSize.x, vScreenSize.y);
-		ld.nResID = renderer->CreateTexture(vScreenSize.x, vScreenSize.y);
-		renderer->UpdateTexture(ld.nResID, ld.pDrawTarget);
+		RunOnRenderThread([&]()
+		{
+			ld.nResID = renderer->CreateTexture(vScreenSize.x, vScreenSize.y);
+			renderer->UpdateTexture(ld.nResID, ld.pDrawTarget);
+		});
 		vLayers.push_back(ld);
 		return uint32_t(vLayers.size()) - 1;
 	}
@@ -1810,8 +4216,53 @@ namespace olc
 	uint32_t PixelGameEngine::GetFPS() const
 	{ return nLastFPS; }
 
+	void PixelGameEngine::SetPipelinedUpdate(bool bEnable, uint32_t nBuffers)
+	{
+		bPipelined = bEnable;
+		nPipelineBuffers = std::clamp(nBuffers, 2u, 3u);
+	}
+
+	bool PixelGameEngine::IsPipelinedUpdate() const
+	{ return bPipelined; }
+
+	void PixelGameEngine::SetFrameRateLimit(float fFramesPerSecond)
+	{ fFrameRateLimit = std::max(0.0f, fFramesPerSecond); }
+
+	void PixelGameEngine::SetIdleFrameRate(float fFramesPerSecond)
+	{ fIdleFrameRate = std::max(0.0f, fFramesPerSecond); }
+
+	void PixelGameEngine::SetIdle(bool idle)
+	{ bIdle = idle; }
+
+	bool PixelGameEngine::IsIdle() const
+	{ return bIdle; }
+
+	olc::FrameStats PixelGameEngine::GetFrameStats() const
+	{
+		olc::FrameStats stats;
+		float fRate = bIdle ? fIdleFrameRate : fFrameRateLimit;
+		if (fRate > 0.0f) stats.fTargetMs = 1000.0 / fRate;
+		stats.nFrames = std::min<uint32_t>(nFrameIntervals, uint32_t(vFrameIntervals.size()));
+		if (stats.nFrames == 0) return stats;
+
+		std::vector<int64_t> vSorted(vFrameIntervals.begin(), vFrameIntervals.begin() + stats.nFrames);
+		std::sort(vSorted.begin(), vSorted.end());
+		double fSum = 0.0, fSumSq = 0.0;
+		for (int64_t n : vSorted)
+		{
+			double ms = double(n) * 1e-6;
+			fSum += ms; fSumSq += ms * ms;
+		}
+		stats.fMeanMs = fSum / stats.nFrames;
+		stats.fStdDevMs = std::sqrt(std::max(0.0, fSumSq / stats.nFrames - stats.fMeanMs * stats.fMeanMs));
+		stats.fMinMs = double(vSorted.front()) * 1e-6;
+		stats.fMaxMs = double(vSorted.back()) * 1e-6;
+		stats.fP99Ms = double(vSorted[(stats.nFrames - 1) * 99 / 100]) * 1e-6;
+		return stats;
+	}
+
 	bool PixelGameEngine::IsFocused() const
-	{ return bHasInputFocus; }
+	{ return bFrameInputFocus; }
 
 	HWButton PixelGameEngine::GetKey(Key k) const
 	{ return pKeyboardState[k];	}
@@ -1819,6 +4270,9 @@ namespace olc
 	HWButton PixelGameEngine::GetMouse(uint32_t b) const
 	{ return pMouseState[b]; }
 
+	const std::vector<olc::InputEvent>& PixelGameEngine::GetInputEvents() const
+	{ return vInputEvents; }
+
 	int32_t PixelGameEngine::GetMouseX() const
 	{ return vMousePos.x; }
 
@@ -1840,135 +4294,315 @@ namespace olc
 	float PixelGameEngine::GetElapsedTime() const
 	{ return fLastElapsed; }
 
+	int64_t PixelGameEngine::GetFrameTimeNs() const
+	{ return nFrameTimeNs; }
+
+	int64_t PixelGameEngine::GetSessionTimeNs() const
+	{ return nSessionTimeNs; }
+
+	double PixelGameEngine::GetSessionTime() const
+	{ return double(nSessionTimeNs) * 1e-9; }
+
+	uint64_t PixelGameEngine::GetFrameIndex() const
+	{ return nFrameIndex; }
+
 	const olc::vi2d& PixelGameEngine::GetWindowSize() const
-	{ return vWindowSize; }
+	{ return vFrameWindowSize; }
 
 	const olc::vi2d& PixelGameEngine::GetPixelSize() const
 	{ return vPixelSize; }
 
 	const olc::vi2d& PixelGameEngine::GetScreenPixelSize() const
-	{ return vScreenPixelSize; }
+	{ return vFrameScreenPixelSize; }
 
 	const olc::vi2d& PixelGameEngine::GetWindowMouse() const
-	{ return vMouseWindowPos; }
+	{ return vFrameMouseWindowPos; }
 
 	bool PixelGameEngine::Draw(const olc::vi2d& pos, Pixel p)
 	{ return Draw(pos.x, pos.y, p); }
 
+	// Set on the threads rasterizing deferred commands, see FlushDeferred()
+	struct DeferredTile
+	{
+		olc::vi2d vMin, vMax;
+		Pixel::Mode nMode = Pixel::NORMAL;
+		float fBlend = 1.0f;
+		const std::function<olc::Pixel(const int x, const int y, const olc::Pixel&, const olc::Pixel&)>* pFunc = nullptr;
+	};
+	static thread_local const DeferredTile* tlsDeferredTile = nullptr;
+
+	// Pixel::ALPHA, shared by Draw() and the span fills so both round alike
+	static inline Pixel BlendAlpha(const Pixel& p, const Pixel& d, float fBlend)
+	{
+		float a = (float)(p.a / 255.0f) * fBlend;
+		float c = 1.0f - a;
+		float r = a * (float)p.r + c * (float)d.r;
+		float g = a * (float)p.g + c * (float)d.g;
+		float b = a * (float)p.b + c * (float)d.b;
+		return Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/);
+	}
+
 	// This is it, the critical function that plots a pixel
 	bool PixelGameEngine::Draw(int32_t x, int32_t y, Pixel p)
 	{
 		if (!pDrawTarget) return false;
 
-		if (nPixelMode == Pixel::NORMAL)
+		Pixel::Mode nMode = nPixelMode;
+		float fBlend = fBlendFactor;
+		const auto* pFunc = &funcPixelMode;
+		if (tlsDeferredTile)
+		{
+			// Rasterizing deferred commands, with the state they were recorded in
+			const DeferredTile& tile = *tlsDeferredTile;
+			if (x < tile.vMin.x || y < tile.vMin.y || x >= tile.vMax.x || y >= tile.vMax.y) return false;
+			nMode = tile.nMode;
+			fBlend = tile.fBlend;
+			pFunc = tile.pFunc;
+		}
+		else if (!vDeferred.empty())
+			FlushDeferred();
+
+		if (nMode == Pixel::NORMAL)
 		{
 			return pDrawTarget->SetPixel(x, y, p);
 		}
 
-		if (nPixelMode == Pixel::MASK)
+		if (nMode == Pixel::MASK)
 		{
 			if (p.a == 255)
 				return pDrawTarget->SetPixel(x, y, p);
 		}
 
-		if (nPixelMode == Pixel::ALPHA)
+		if (nMode == Pixel::ALPHA)
 		{
-			Pixel d = pDrawTarget->GetPixel(x, y);
-			float a = (float)(p.a / 255.0f) * fBlendFactor;
-			float c = 1.0f - a;
-			float r = a * (float)p.r + c * (float)d.r;
-			float g = a * (float)p.g + c * (float)d.g;
-			float b = a * (float)p.b + c * (float)d.b;
-			return pDrawTarget->SetPixel(x, y, Pixel((uint8_t)r, (uint8_t)g, (uint8_t)b/*, (uint8_t)(p.a * fBlendFactor)*/));
+			return pDrawTarget->SetPixel(x, y, BlendAlpha(p, pDrawTarget->GetPixel(x, y), fBlend));
 		}
 
-		if (nPixelMode == Pixel::CUSTOM)
+		if (nMode == Pixel::CUSTOM)
 		{
-			return pDrawTarget->SetPixel(x, y, funcPixelMode(x, y, p, pDrawTarget->GetPixel(x, y)));
+			return pDrawTarget->SetPixel(x, y, (*pFunc)(x, y, p, pDrawTarget->GetPixel(x, y)));
 		}
 
 		return false;
 	}
 
+	PixelGameEngine::SpanTarget PixelGameEngine::olc_GetSpanTarget()
+	{
+		SpanTarget st;
+		st.pTarget = pDrawTarget;
+		olc_GetClip(st.vClipMin, st.vClipMax);
+		if (tlsDeferredTile)
+		{
+			st.nMode = tlsDeferredTile->nMode;
+			st.fBlend = tlsDeferredTile->fBlend;
+			st.pFunc = tlsDeferredTile->pFunc;
+		}
+		else
+		{
+			if (!vDeferred.empty()) FlushDeferred();
+			st.nMode = nPixelMode;
+			st.fBlend = fBlendFactor;
+			st.pFunc = &funcPixelMode;
+		}
+		return st;
+	}
+
+	// Fills x1 to x2 inclusive on row y. Clipped once, then the row is written
+	// directly in a loop the compiler can vectorise, rather than per Draw().
+	void PixelGameEngine::olc_FillSpan(const SpanTarget& st, int32_t x1, int32_t x2, int32_t y, Pixel p)
+	{
+		if (y < st.vClipMin.y || y >= st.vClipMax.y) return;
+		x1 = std::max(x1, st.vClipMin.x);
+		x2 = std::min(x2, st.vClipMax.x - 1);
+		if (x1 > x2) return;
+
+		Pixel* row = st.pTarget->GetData() + size_t(y) * size_t(st.pTarget->width);
+		switch (st.nMode)
+		{
+		case Pixel::MASK:
+			if (p.a != 255) break;
+			[[fallthrough]];
+		case Pixel::NORMAL:
+			std::fill(row + x1, row + x2 + 1, p);
+			break;
+		case Pixel::ALPHA:
+			for (int32_t x = x1; x <= x2; x++) row[x] = BlendAlpha(p, row[x], st.fBlend);
+			break;
+		case Pixel::CUSTOM:
+			for (int32_t x = x1; x <= x2; x++) row[x] = (*st.pFunc)(x, y, p, row[x]);
+			break;
+		}
+	}
+
+	// Writes n source pixels from (x,y) on, already clipped, as Draw() would
+	void PixelGameEngine::olc_BlendSpan(const SpanTarget& st, int32_t x, int32_t y, const Pixel* pSrc, int32_t n)
+	{
+		Pixel* row = st.pTarget->GetData() + size_t(y) * size_t(st.pTarget->width) + x;
+		switch (st.nMode)
+		{
+		case Pixel::NORMAL:
+			if (row != pSrc) std::copy(pSrc, pSrc + n, row);
+			break;
+		case Pixel::MASK:
+			for (int32_t i = 0; i < n; i++) if (pSrc[i].a == 255) row[i] = pSrc[i];
+			break;
+		case Pixel::ALPHA:
+			for (int32_t i = 0; i < n; i++) row[i] = BlendAlpha(pSrc[i], row[i], st.fBlend);
+			break;
+		case Pixel::CUSTOM:
+			for (int32_t i = 0; i < n; i++) row[i] = (*st.pFunc)(x + i, y, pSrc[i], row[i]);
+			break;
+		}
+	}
 
 	void PixelGameEngine::DrawLine(const olc::vi2d& pos1, const olc::vi2d& pos2, Pixel p, uint32_t pattern)
 	{ DrawLine(pos1.x, pos1.y, pos2.x, pos2.y, p, pattern); }
 
 	void PixelGameEngine::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p, uint32_t pattern)
+	{ olc_DrawLine(olc_GetSpanTarget(), x1, y1, x2, y2, p, pattern); }
+
+	void PixelGameEngine::DrawLines(const std::vector<olc::vi2d>& vPoints, Pixel p, uint32_t pattern)
 	{
-		int x, y, dx, dy, dx1, dy1, px, py, xe, ye, i;
-		dx = x2 - x1; dy = y2 - y1;
+		const SpanTarget st = olc_GetSpanTarget();
+		for (size_t i = 0; i + 1 < vPoints.size(); i += 2)
+			olc_DrawLine(st, vPoints[i].x, vPoints[i].y, vPoints[i + 1].x, vPoints[i + 1].y, p, pattern);
+	}
 
-		auto rol = [&](void) { pattern = (pattern << 1) | (pattern >> 31); return pattern & 1; };
+	void PixelGameEngine::DrawLines(const std::vector<olc::vi2d>& vPoints, const std::vector<olc::Pixel>& vColours, uint32_t pattern)
+	{
+		const SpanTarget st = olc_GetSpanTarget();
+		for (size_t i = 0; i + 1 < vPoints.size() && i / 2 < vColours.size(); i += 2)
+			olc_DrawLine(st, vPoints[i].x, vPoints[i].y, vPoints[i + 1].x, vPoints[i + 1].y, vColours[i / 2], pattern);
+	}
 
-		// straight lines idea by gurkanctn
-		if (dx == 0) // Line is vertical
+	// As Draw() for a pixel known to be inside the clip area
+	void PixelGameEngine::olc_PlotClipped(const SpanTarget& st, int32_t x, int32_t y, Pixel p)
+	{
+		Pixel& d = st.pTarget->GetData()[size_t(y) * size_t(st.pTarget->width) + size_t(x)];
+		switch (st.nMode)
 		{
-			if (y2 < y1) std::swap(y1, y2);
-			for (y = y1; y <= y2; y++) if (rol()) Draw(x1, y, p);
-			return;
+		case Pixel::MASK: if (p.a == 255) d = p; break;
+		case Pixel::NORMAL: d = p; break;
+		case Pixel::ALPHA: d = BlendAlpha(p, d, st.fBlend); break;
+		case Pixel::CUSTOM: d = (*st.pFunc)(x, y, p, d); break;
 		}
+	}
 
-		if (dy == 0) // Line is horizontal
-		{
-			if (x2 < x1) std::swap(x1, x2);
-			for (x = x1; x <= x2; x++) if (rol()) Draw(x, y1, p);
-			return;
-		}
+	// Bresenham as it always was, but only the steps that land in the clip area
+	// are walked. Cutting the line at rounded intersections would shift its
+	// pixels, so the first and last visible steps are solved for exactly from
+	// the error term instead, and the pattern picks up where it would have.
+	void PixelGameEngine::olc_DrawLine(const SpanTarget& st, int32_t x1, int32_t y1, int32_t x2, int32_t y2, Pixel p, uint32_t pattern)
+	{
+		const olc::vi2d& vMin = st.vClipMin;
+		const olc::vi2d& vMax = st.vClipMax;
 
-		// Line is Funk-aye
-		dx1 = abs(dx); dy1 = abs(dy);
-		px = 2 * dy1 - dx1;	py = 2 * dx1 - dy1;
-		if (dy1 <= dx1)
+		// Cohen-Sutherland outcodes, both ends beyond the same edge draws nothing
+		auto outcode = [&](int32_t x, int32_t y)
 		{
-			if (dx >= 0)
-			{
-				x = x1; y = y1; xe = x2;
-			}
-			else
+			return (x < vMin.x ? 1 : 0) | (x >= vMax.x ? 2 : 0) | (y < vMin.y ? 4 : 0) | (y >= vMax.y ? 8 : 0);
+		};
+		if (outcode(x1, y1) & outcode(x2, y2)) return;
+
+		// The pattern is rotated left once per pixel and its low bit tested, so
+		// pixel k uses bit 31 - k. Reversed once, pixel k uses bit k.
+		uint32_t nBits = pattern;
+		nBits = ((nBits >> 1) & 0x55555555) | ((nBits & 0x55555555) << 1);
+		nBits = ((nBits >> 2) & 0x33333333) | ((nBits & 0x33333333) << 2);
+		nBits = ((nBits >> 4) & 0x0F0F0F0F) | ((nBits & 0x0F0F0F0F) << 4);
+		nBits = ((nBits >> 8) & 0x00FF00FF) | ((nBits & 0x00FF00FF) << 8);
+		nBits = (nBits >> 16) | (nBits << 16);
+		auto bit = [&](int64_t k) { return (nBits >> (k & 31)) & 1; };
+
+		const int64_t dx = int64_t(x2) - x1, dy = int64_t(y2) - y1;
+
+		// straight lines idea by gurkanctn, now filled as spans
+		if (dx == 0 || dy == 0)
+		{
+			const bool bVertical = dx == 0;
+			const int32_t s0 = bVertical ? std::min(y1, y2) : std::min(x1, x2);
+			const int32_t s1 = bVertical ? std::max(y1, y2) : std::max(x1, x2);
+			const int32_t c0 = bVertical ? vMin.y : vMin.x;
+			const int32_t c1 = (bVertical ? vMax.y : vMax.x) - 1;
+			const int64_t k0 = std::max(int64_t(0), int64_t(c0) - s0);
+			const int64_t k1 = std::min(int64_t(s1) - s0, int64_t(c1) - s0);
+
+			if (pattern == 0xFFFFFFFF && !bVertical)
 			{
-				x = x2; y = y2; xe = x1;
+				olc_FillSpan(st, int32_t(s0 + k0), int32_t(s0 + k1), y1, p);
+				return;
 			}
 
-			if (rol()) Draw(x, y, p);
-
-			for (i = 0; x < xe; i++)
+			// Pattern words give the next 32 pixels at a time, gaps are skipped
+			for (int64_t k = k0; k <= k1; k += 32)
 			{
-				x = x + 1;
-				if (px < 0)
-					px = px + 2 * dy1;
-				else
+				const uint32_t nShift = uint32_t(k & 31);
+				uint32_t nMask = nShift ? (nBits >> nShift) | (nBits << (32 - nShift)) : nBits;
+				if (k1 - k < 31) nMask &= (1u << (k1 - k + 1)) - 1;
+				for (int32_t j = 0; nMask; j++, nMask >>= 1)
 				{
-					if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) y = y + 1; else y = y - 1;
-					px = px + 2 * (dy1 - dx1);
+					if (!(nMask & 1)) continue;
+					const int32_t s = int32_t(s0 + k + j);
+					if (bVertical) olc_PlotClipped(st, x1, s, p);
+					else olc_PlotClipped(st, s, y1, p);
 				}
-				if (rol()) Draw(x, y, p);
 			}
+			return;
 		}
-		else
-		{
-			if (dy >= 0)
+
+		// Line is Funk-aye
+		const int64_t dx1 = std::abs(dx), dy1 = std::abs(dy);
+		const int32_t nMinorStep = ((dx < 0) == (dy < 0)) ? 1 : -1;
+		const bool bXMajor = dy1 <= dx1;
+		const int64_t nMajor = bXMajor ? dx1 : dy1;
+		const int64_t nMinor = bXMajor ? dy1 : dx1;
+
+		// Walked from the end with the lower major coordinate
+		const bool bFromFirst = bXMajor ? dx >= 0 : dy >= 0;
+		const int32_t ma = bXMajor ? (bFromFirst ? x1 : x2) : (bFromFirst ? y1 : y2);
+		const int32_t mi = bXMajor ? (bFromFirst ? y1 : y2) : (bFromFirst ? x1 : x2);
+		const int32_t cMa0 = bXMajor ? vMin.x : vMin.y, cMa1 = (bXMajor ? vMax.x : vMax.y) - 1;
+		const int32_t cMi0 = bXMajor ? vMin.y : vMin.x, cMi1 = (bXMajor ? vMax.y : vMax.x) - 1;
+
+		// After k steps the minor axis has moved m(k) = floor((2 nMinor k + b) / (2 nMajor)),
+		// b being nMajor for x major lines, which step on e >= 0, and nMajor - 1 for
+		// y major lines, which step on e > 0. Also the first k where m(k) >= m.
+		const int64_t b = bXMajor ? nMajor : nMajor - 1;
+		auto minorAt = [&](int64_t k) { return (2 * nMinor * k + b) / (2 * nMajor); };
+		auto firstStep = [&](int64_t m)
+		{
+			if (m <= 0) return int64_t(0);
+			const int64_t n = 2 * nMajor * m - b;
+			return (n + 2 * nMinor - 1) / (2 * nMinor);
+		};
+
+		int64_t k0 = std::max(int64_t(0), int64_t(cMa0) - ma);
+		int64_t k1 = std::min(nMajor, int64_t(cMa1) - ma);
+		const int64_t m0 = nMinorStep > 0 ? int64_t(cMi0) - mi : int64_t(mi) - cMi1;
+		const int64_t m1 = nMinorStep > 0 ? int64_t(cMi1) - mi : int64_t(mi) - cMi0;
+		if (m1 < 0) return;
+		k0 = std::max(k0, firstStep(m0));
+		k1 = std::min(k1, firstStep(m1 + 1) - 1);
+		if (k0 > k1) return;
+
+		int64_t m = minorAt(k0);
+		int64_t e = 2 * nMinor * (k0 + 1) - nMajor - 2 * nMajor * m;
+		int32_t a = int32_t(ma + k0);
+		int32_t c = int32_t(mi + nMinorStep * m);
+		for (int64_t k = k0; k <= k1; k++)
+		{
+			if (bit(k))
 			{
-				x = x1; y = y1; ye = y2;
+				if (bXMajor) olc_PlotClipped(st, a, c, p);
+				else olc_PlotClipped(st, c, a, p);
 			}
+			a++;
+			if (bXMajor ? e < 0 : e <= 0)
+				e += 2 * nMinor;
 			else
 			{
-				x = x2; y = y2; ye = y1;
-			}
-
-			if (rol()) Draw(x, y, p);
-
-			for (i = 0; y < ye; i++)
-			{
-				y = y + 1;
-				if (py <= 0)
-					py = py + 2 * dx1;
-				else
-				{
-					if ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) x = x + 1; else x = x - 1;
-					py = py + 2 * (dx1 - dy1);
-				}
-				if (rol()) Draw(x, y, p);
+				c += nMinorStep;
+				e += 2 * (nMinor - nMajor);
 			}
 		}
 	}
@@ -2020,17 +4654,17 @@ namespace olc
 		if (radius < 0 || x < -radius || y < -radius || x - GetDrawTargetWidth() > radius || y - GetDrawTargetHeight() > radius)
 			return;
 
+		if (olc_Defer(DrawCommand::Type::FILL_CIRCLE, p, { x - radius, y - radius }, { x + radius + 1, y + radius + 1 }, { x, y, radius }))
+			return;
+
 		if (radius > 0)
 		{
 			int x0 = 0;
 			int y0 = radius;
 			int d = 3 - 2 * radius;
 
-			auto drawline = [&](int sx, int ex, int y)
-			{
-				for (int x = sx; x <= ex; x++)
-					Draw(x, y, p);
-			};
+			const SpanTarget st = olc_GetSpanTarget();
+			auto drawline = [&](int sx, int ex, int y) { olc_FillSpan(st, sx, ex, y, p); };
 
 			while (y0 >= x0)
 			{
@@ -2067,13 +4701,18 @@ namespace olc
 
 	void PixelGameEngine::Clear(Pixel p)
 	{
-		int pixels = GetDrawTargetWidth() * GetDrawTargetHeight();
+		if (olc_Defer(DrawCommand::Type::CLEAR, p, { 0, 0 }, { GetDrawTargetWidth(), GetDrawTargetHeight() }, {}))
+			return;
+
+		olc::vi2d vClipMin, vClipMax;
+		olc_GetClip(vClipMin, vClipMax);
 		Pixel* m = GetDrawTarget()->GetData();
-		for (int i = 0; i < pixels; i++) m[i] = p;
+		for (int y = vClipMin.y; y < vClipMax.y; y++)
+			std::fill(m + y * GetDrawTargetWidth() + vClipMin.x, m + y * GetDrawTargetWidth() + vClipMax.x, p);
 	}
 
 	void PixelGameEngine::ClearBuffer(Pixel p, bool bDepth)
-	{ renderer->ClearBuffer(p, bDepth);	}
+	{ RunOnRenderThread([&]() { renderer->ClearBuffer(p, bDepth); }); }
 
 	olc::Sprite* PixelGameEngine::GetFontSprite()
 	{ return fontSprite; }
@@ -2083,22 +4722,14 @@ namespace olc
 
 	void PixelGameEngine::FillRect(int32_t x, int32_t y, int32_t w, int32_t h, Pixel p)
 	{
-		int32_t x2 = x + w;
-		int32_t y2 = y + h;
-
-		if (x < 0) x = 0;
-		if (x >= (int32_t)GetDrawTargetWidth()) x = (int32_t)GetDrawTargetWidth();
-		if (y < 0) y = 0;
-		if (y >= (int32_t)GetDrawTargetHeight()) y = (int32_t)GetDrawTargetHeight();
-
-		if (x2 < 0) x2 = 0;
-		if (x2 >= (int32_t)GetDrawTargetWidth()) x2 = (int32_t)GetDrawTargetWidth();
-		if (y2 < 0) y2 = 0;
-		if (y2 >= (int32_t)GetDrawTargetHeight()) y2 = (int32_t)GetDrawTargetHeight();
+		if (olc_Defer(DrawCommand::Type::FILL_RECT, p, { x, y }, { x + w, y + h }, { x, y, w, h }))
+			return;
 
-		for (int i = x; i < x2; i++)
-			for (int j = y; j < y2; j++)
-				Draw(i, j, p);
+		const SpanTarget st = olc_GetSpanTarget();
+		const int32_t y1 = std::max(y, st.vClipMin.y);
+		const int32_t y2 = std::min(y + h, st.vClipMax.y);
+		for (int32_t j = y1; j < y2; j++)
+			olc_FillSpan(st, x, x + w - 1, j, p);
 	}
 
 	void PixelGameEngine::DrawTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p)
@@ -2114,10 +4745,66 @@ namespace olc
 	void PixelGameEngine::FillTriangle(const olc::vi2d& pos1, const olc::vi2d& pos2, const olc::vi2d& pos3, Pixel p)
 	{ FillTriangle(pos1.x, pos1.y, pos2.x, pos2.y, pos3.x, pos3.y, p); }
 
-	// https://www.avrfreaks.net/sites/default/files/triangles.c
 	void PixelGameEngine::FillTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
 	{
-		auto drawline = [&](int sx, int ex, int ny) { for (int i = sx; i <= ex; i++) Draw(i, ny, p); };
+		if (olc_Defer(DrawCommand::Type::FILL_TRIANGLE, p,
+			{ std::min({ x1, x2, x3 }), std::min({ y1, y2, y3 }) },
+			{ std::max({ x1, x2, x3 }) + 1, std::max({ y1, y2, y3 }) + 1 },
+			{ x1, y1, x2, y2, x3, y3 }))
+			return;
+
+		olc_FillTriangle(olc_GetSpanTarget(), x1, y1, x2, y2, x3, y3, p);
+	}
+
+	void PixelGameEngine::FillTriangles(const std::vector<olc::vi2d>& vVertices, Pixel p)
+	{
+		if (bDeferred && !tlsDeferredTile)
+		{
+			for (size_t i = 0; i + 2 < vVertices.size(); i += 3)
+				FillTriangle(vVertices[i], vVertices[i + 1], vVertices[i + 2], p);
+			return;
+		}
+
+		const SpanTarget st = olc_GetSpanTarget();
+		for (size_t i = 0; i + 2 < vVertices.size(); i += 3)
+		{
+			const olc::vi2d& a = vVertices[i];
+			const olc::vi2d& b = vVertices[i + 1];
+			const olc::vi2d& c = vVertices[i + 2];
+			// Skip those entirely off the clip area without walking their edges
+			if (std::max({ a.x, b.x, c.x }) < st.vClipMin.x || std::min({ a.x, b.x, c.x }) >= st.vClipMax.x ||
+				std::max({ a.y, b.y, c.y }) < st.vClipMin.y || std::min({ a.y, b.y, c.y }) >= st.vClipMax.y)
+				continue;
+			olc_FillTriangle(st, a.x, a.y, b.x, b.y, c.x, c.y, p);
+		}
+	}
+
+	void PixelGameEngine::FillTriangles(const std::vector<olc::vi2d>& vVertices, const std::vector<olc::Pixel>& vColours)
+	{
+		if (bDeferred && !tlsDeferredTile)
+		{
+			for (size_t i = 0; i + 2 < vVertices.size() && i / 3 < vColours.size(); i += 3)
+				FillTriangle(vVertices[i], vVertices[i + 1], vVertices[i + 2], vColours[i / 3]);
+			return;
+		}
+
+		const SpanTarget st = olc_GetSpanTarget();
+		for (size_t i = 0; i + 2 < vVertices.size() && i / 3 < vColours.size(); i += 3)
+		{
+			const olc::vi2d& a = vVertices[i];
+			const olc::vi2d& b = vVertices[i + 1];
+			const olc::vi2d& c = vVertices[i + 2];
+			if (std::max({ a.x, b.x, c.x }) < st.vClipMin.x || std::min({ a.x, b.x, c.x }) >= st.vClipMax.x ||
+				std::max({ a.y, b.y, c.y }) < st.vClipMin.y || std::min({ a.y, b.y, c.y }) >= st.vClipMax.y)
+				continue;
+			olc_FillTriangle(st, a.x, a.y, b.x, b.y, c.x, c.y, vColours[i / 3]);
+		}
+	}
+
+	// https://www.avrfreaks.net/sites/default/files/triangles.c
+	void PixelGameEngine::olc_FillTriangle(const SpanTarget& st, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, Pixel p)
+	{
+		auto drawline = [&](int sx, int ex, int ny) { olc_FillSpan(st, sx, ex, ny, p); };
 
 		int t1x, t2x, y, minx, maxx, t1xp, t2xp;
 		bool changed1 = false;
@@ -2258,32 +4945,39 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
-		int32_t fxs = 0, fxm = 1, fx = 0;
-		int32_t fys = 0, fym = 1, fy = 0;
+		const int32_t s = int32_t(std::max(scale, 1u));
+		if (olc_Defer(DrawCommand::Type::DRAW_SPRITE, olc::BLANK, { x, y }, { x + sprite->width * s, y + sprite->height * s }, { x, y }, sprite, scale, flip))
+			return;
+
+		int32_t fxs = 0, fxm = 1;
+		int32_t fys = 0, fym = 1;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = sprite->width - 1; fxm = -1; }
 		if (flip & olc::Sprite::Flip::VERT) { fys = sprite->height - 1; fym = -1; }
 
+		// Only visit the sprite pixels that land in the clip area
+		olc::vi2d vClipMin, vClipMax;
+		olc_GetClip(vClipMin, vClipMax);
+		const int32_t i0 = vClipMin.x > x ? (vClipMin.x - x) / s : 0;
+		const int32_t j0 = vClipMin.y > y ? (vClipMin.y - y) / s : 0;
+		const int32_t i1 = vClipMax.x > x ? std::min(sprite->width, (vClipMax.x - x + s - 1) / s) : 0;
+		const int32_t j1 = vClipMax.y > y ? std::min(sprite->height, (vClipMax.y - y + s - 1) / s) : 0;
+
 		if (scale > 1)
 		{
-			fx = fxs;
-			for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-					for (uint32_t is = 0; is < scale; is++)
-						for (uint32_t js = 0; js < scale; js++)
-							Draw(x + (i * scale) + is, y + (j * scale) + js, sprite->GetPixel(fx, fy));
-			}
+			for (int32_t j = j0; j < j1; j++)
+				for (int32_t i = i0; i < i1; i++)
+				{
+					Pixel p = sprite->GetPixel(fxs + i * fxm, fys + j * fym);
+					for (uint32_t js = 0; js < scale; js++)
+						for (uint32_t is = 0; is < scale; is++)
+							Draw(x + (i * scale) + is, y + (j * scale) + js, p);
+				}
 		}
 		else
 		{
-			fx = fxs;
-			for (int32_t i = 0; i < sprite->width; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < sprite->height; j++, fy += fym)
-					Draw(x + i, y + j, sprite->GetPixel(fx, fy));
-			}
+			for (int32_t j = j0; j < j1; j++)
+				for (int32_t i = i0; i < i1; i++)
+					Draw(x + i, y + j, sprite->GetPixel(fxs + i * fxm, fys + j * fym));
 		}
 	}
 
@@ -2295,38 +4989,222 @@ namespace olc
 		if (sprite == nullptr)
 			return;
 
-		int32_t fxs = 0, fxm = 1, fx = 0;
-		int32_t fys = 0, fym = 1, fy = 0;
+		const int32_t s = int32_t(std::max(scale, 1u));
+		if (olc_Defer(DrawCommand::Type::DRAW_PARTIAL_SPRITE, olc::BLANK, { x, y }, { x + w * s, y + h * s }, { x, y, ox, oy, w, h }, sprite, scale, flip))
+			return;
+
+		int32_t fxs = 0, fxm = 1;
+		int32_t fys = 0, fym = 1;
 		if (flip & olc::Sprite::Flip::HORIZ) { fxs = w - 1; fxm = -1; }
 		if (flip & olc::Sprite::Flip::VERT) { fys = h - 1; fym = -1; }
 
+		olc::vi2d vClipMin, vClipMax;
+		olc_GetClip(vClipMin, vClipMax);
+		const int32_t i0 = vClipMin.x > x ? (vClipMin.x - x) / s : 0;
+		const int32_t j0 = vClipMin.y > y ? (vClipMin.y - y) / s : 0;
+		const int32_t i1 = vClipMax.x > x ? std::min(w, (vClipMax.x - x + s - 1) / s) : 0;
+		const int32_t j1 = vClipMax.y > y ? std::min(h, (vClipMax.y - y + s - 1) / s) : 0;
+
 		if (scale > 1)
 		{
-			fx = fxs;
-			for (int32_t i = 0; i < w; i++, fx += fxm)
-			{
-				fy = fys;
-				for (int32_t j = 0; j < h; j++, fy += fym)
-					for (uint32_t is = 0; is < scale; is++)
-						for (uint32_t js = 0; js < scale; js++)
-							Draw(x + (i * scale) + is, y + (j * scale) + js, sprite->GetPixel(fx + ox, fy + oy));
-			}
+			for (int32_t j = j0; j < j1; j++)
+				for (int32_t i = i0; i < i1; i++)
+				{
+					Pixel p = sprite->GetPixel(fxs + i * fxm + ox, fys + j * fym + oy);
+					for (uint32_t js = 0; js < scale; js++)
+						for (uint32_t is = 0; is < scale; is++)
+							Draw(x + (i * scale) + is, y + (j * scale) + js, p);
+				}
 		}
 		else
 		{
-			fx = fxs;
-			for (int32_t i = 0; i < w; i++, fx += fxm)
+			for (int32_t j = j0; j < j1; j++)
+				for (int32_t i = i0; i < i1; i++)
+					Draw(x + i, y + j, sprite->GetPixel(fxs + i * fxm + ox, fys + j * fym + oy));
+		}
+	}
+
+	void PixelGameEngine::DrawRotatedSprite(const olc::vf2d& pos, Sprite* sprite, const float fAngle, const olc::vf2d& center, const olc::vf2d& scale, bool bFilter)
+	{
+		const float c = std::cos(fAngle), s = std::sin(fAngle);
+		const olc::vf2d vAxisX = olc::vf2d(c, s) * scale.x;
+		const olc::vf2d vAxisY = olc::vf2d(-s, c) * scale.y;
+		DrawSpriteTransformed(sprite, pos - vAxisX * center.x - vAxisY * center.y, vAxisX, vAxisY, bFilter);
+	}
+
+	void PixelGameEngine::DrawSpriteTransformed(Sprite* sprite, const olc::vf2d& vOrigin, const olc::vf2d& vAxisX, const olc::vf2d& vAxisY, bool bFilter)
+	{
+		if (sprite == nullptr || sprite->width <= 0 || sprite->height <= 0 || pDrawTarget == nullptr)
+			return;
+
+		const double det = double(vAxisX.x) * vAxisY.y - double(vAxisX.y) * vAxisY.x;
+		if (!std::isfinite(det) || std::abs(det) < 1e-12)
+			return;
+
+		// Bounding box of the four corners, whole pixels, clamped to sane ints
+		const olc::vf2d vCorner[4] = { vOrigin, vOrigin + vAxisX * float(sprite->width),
+			vOrigin + vAxisY * float(sprite->height), vOrigin + vAxisX * float(sprite->width) + vAxisY * float(sprite->height) };
+		double dMinX = vCorner[0].x, dMaxX = vCorner[0].x, dMinY = vCorner[0].y, dMaxY = vCorner[0].y;
+		for (const auto& v : vCorner)
+		{
+			dMinX = std::min(dMinX, double(v.x)); dMaxX = std::max(dMaxX, double(v.x));
+			dMinY = std::min(dMinY, double(v.y)); dMaxY = std::max(dMaxY, double(v.y));
+		}
+		if (!std::isfinite(dMinX + dMaxX + dMinY + dMaxY)) return;
+		auto ToInt = [](double d) { return int32_t(std::clamp(d, -1073741824.0, 1073741824.0)); };
+		const olc::vi2d vMin = { ToInt(std::floor(dMinX)), ToInt(std::floor(dMinY)) };
+		const olc::vi2d vMax = { ToInt(std::ceil(dMaxX)) + 1, ToInt(std::ceil(dMaxY)) + 1 };
+
+		if (olc_Defer(DrawCommand::Type::DRAW_TRANSFORMED, olc::BLANK, vMin, vMax, {}, sprite, 1, uint8_t(bFilter),
+			{ vOrigin.x, vOrigin.y, vAxisX.x, vAxisX.y, vAxisY.x, vAxisY.y }))
+			return;
+
+		const SpanTarget st = olc_GetSpanTarget();
+		const int32_t y0 = std::max(vMin.y, st.vClipMin.y), y1 = std::min(vMax.y, st.vClipMax.y);
+		if (y0 >= y1) return;
+
+		// Sprite texel coordinate of each pixel centre, in 32.32 fixed point. Rows
+		// step from the left of the bounding box however they are clipped, so
+		// deferred tiles produce the same pixels as one immediate call.
+		const double ix = double(vAxisY.y) / det, iy = -double(vAxisX.y) / det;
+		if (std::abs(ix) > 1048576.0 || std::abs(iy) > 1048576.0) return;
+		const double fOne = 4294967296.0;
+		auto ToFixed = [fOne](double d) { return std::llround(std::clamp(d * fOne, -4.0e18, 4.0e18)); };
+		const int64_t tdx = ToFixed(ix), tdy = ToFixed(iy);
+		const int64_t nLimitX = int64_t(sprite->width) << 32, nLimitY = int64_t(sprite->height) << 32;
+
+		// Range of k with 0 <= t0 + k * dt < nLimit, in whole pixels
+		auto FloorDiv = [](int64_t a, int64_t b) { int64_t q = a / b; return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q; };
+		auto Span = [&](int64_t t0, int64_t dt, int64_t nLimit, int32_t& x1, int32_t& x2)
+		{
+			if (dt == 0)
+			{
+				if (t0 < 0 || t0 >= nLimit) x2 = x1 - 1;
+				return;
+			}
+			int64_t lo = dt > 0 ? -FloorDiv(t0, dt) : -FloorDiv(t0 - (nLimit - 1), dt);
+			int64_t hi = dt > 0 ? FloorDiv(nLimit - 1 - t0, dt) : FloorDiv(-t0, dt);
+			x1 = int32_t(std::max<int64_t>(x1, lo));
+			x2 = int32_t(std::min<int64_t>(x2, hi));
+		};
+
+		static thread_local std::vector<olc::Pixel> vRow;
+		const olc::Pixel* pSrc = sprite->pColData.data();
+		const olc::Sprite::Format format = sprite->GetFormat();
+		const uint32_t nSize = olc::Sprite::GetFormatSize(format);
+		const int32_t nTilesX = (sprite->width + 7) >> 3;
+		for (int32_t y = y0; y < y1; y++)
+		{
+			const double px = vMin.x + 0.5 - vOrigin.x, py = y + 0.5 - vOrigin.y;
+			const int64_t t0x = ToFixed((double(vAxisY.y) * px - double(vAxisY.x) * py) / det);
+			const int64_t t0y = ToFixed((double(vAxisX.x) * py - double(vAxisX.y) * px) / det);
+
+			int32_t k1 = std::max(vMin.x, st.vClipMin.x) - vMin.x, k2 = std::min(vMax.x, st.vClipMax.x) - 1 - vMin.x;
+			Span(t0x, tdx, nLimitX, k1, k2);
+			Span(t0y, tdy, nLimitY, k1, k2);
+			if (k1 > k2) continue;
+
+			const int32_t x1 = vMin.x + k1, n = k2 - k1 + 1;
+			olc::Pixel* pDest;
+			if (st.nMode == Pixel::NORMAL)
+				pDest = st.pTarget->GetData() + size_t(y) * size_t(st.pTarget->width) + x1;
+			else
 			{
-				fy = fys;
-				for (int32_t j = 0; j < h; j++, fy += fym)
-					Draw(x + i, y + j, sprite->GetPixel(fx + ox, fy + oy));
+				if (vRow.size() < size_t(n)) vRow.resize(size_t(n));
+				pDest = vRow.data();
 			}
+
+			int64_t tx = t0x + k1 * tdx, ty = t0y + k1 * tdy;
+			if (bFilter)
+				SampleBLRowFixed(sprite, pDest, uint32_t(n), tx - (int64_t(1) << 31), ty - (int64_t(1) << 31), tdx, tdy);
+			else if (format == olc::Sprite::Format::RGBA8 && sprite->GetLayout() == olc::Sprite::Layout::LINEAR)
+				for (int32_t i = 0; i < n; i++, tx += tdx, ty += tdy)
+					pDest[i] = pSrc[size_t(ty >> 32) * size_t(sprite->width) + size_t(tx >> 32)];
+			else if (format == olc::Sprite::Format::RGBA8)
+				for (int32_t i = 0; i < n; i++, tx += tdx, ty += tdy)
+					pDest[i] = pSrc[olc::Sprite::GetTiledIndex(int32_t(tx >> 32), int32_t(ty >> 32), nTilesX)];
+			else
+				for (int32_t i = 0; i < n; i++, tx += tdx, ty += tdy)
+					pDest[i] = UnpackTexel(format, sprite->GetRawData() + sprite->GetTexelIndex(int32_t(tx >> 32), int32_t(ty >> 32)) * nSize);
+
+			olc_BlendSpan(st, x1, y, pDest, n);
 		}
 	}
 
 	void PixelGameEngine::SetDecalMode(const olc::DecalMode& mode)
 	{ nDecalMode = mode; }
 
+	void PixelGameEngine::SetDecalSortLayer(uint16_t nSortLayer)
+	{ nDecalSortLayer = nSortLayer; }
+
+	void PixelGameEngine::olc_SubmitDecal(DecalInstance& di)
+	{
+		LayerDesc& layer = vLayers[nTargetLayer];
+		if (layer.bSortDecals)
+		{
+			// Most significant first: sort layer, decal mode, texture
+			const uint32_t nTexture = di.decal ? uint32_t(di.decal->id) : 0;
+			di.key = (uint64_t(nDecalSortLayer) << 48) | (uint64_t(uint8_t(di.mode)) << 40) | nTexture;
+		}
+		layer.vecDecalInstance.push_back(std::move(di));
+	}
+
+	void PixelGameEngine::olc_SortDecals(std::vector<DecalInstance>& vDecals)
+	{
+		const uint32_t n = uint32_t(vDecals.size());
+		bool bSorted = true;
+		for (uint32_t i = 1; i < n && bSorted; i++)
+			bSorted = vDecals[i - 1].key <= vDecals[i].key;
+		if (bSorted) return;
+
+		// Stable radix sort, least significant byte first. Keys are sorted
+		// along with the indices of their decals, which are moved just once.
+		uint64_t* pKeys[2] = { nullptr, nullptr };
+		uint32_t* pOrder[2] = { nullptr, nullptr };
+		for (int k = 0; k < 2; k++)
+		{
+			vDecalSortKeys[k].resize(n);
+			vDecalSortOrder[k].resize(n);
+			pKeys[k] = vDecalSortKeys[k].data();
+			pOrder[k] = vDecalSortOrder[k].data();
+		}
+
+		uint32_t nCount[8][256] = {};
+		for (uint32_t i = 0; i < n; i++)
+		{
+			const uint64_t key = vDecals[i].key;
+			pKeys[0][i] = key;
+			pOrder[0][i] = i;
+			for (int b = 0; b < 8; b++) nCount[b][(key >> (b * 8)) & 0xFF]++;
+		}
+
+		int src = 0;
+		for (int b = 0; b < 8; b++)
+		{
+			// Skip bytes every key shares, usually most of them
+			uint32_t* pCount = nCount[b];
+			if (pCount[(pKeys[src][0] >> (b * 8)) & 0xFF] == n) continue;
+
+			uint32_t nOffset = 0;
+			for (int d = 0; d < 256; d++) { const uint32_t c = pCount[d]; pCount[d] = nOffset; nOffset += c; }
+
+			for (uint32_t i = 0; i < n; i++)
+			{
+				const uint32_t nPos = pCount[(pKeys[src][i] >> (b * 8)) & 0xFF]++;
+				pKeys[src ^ 1][nPos] = pKeys[src][i];
+				pOrder[src ^ 1][nPos] = pOrder[src][i];
+			}
+			src ^= 1;
+		}
+
+		vDecalSortScratch.clear();
+		vDecalSortScratch.reserve(n);
+		for (uint32_t i = 0; i < n; i++)
+			vDecalSortScratch.push_back(std::move(vDecals[pOrder[src][i]]));
+		vDecals.swap(vDecalSortScratch);
+		vDecalSortScratch.clear();
+	}
+
 	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale, const olc::Pixel& tint)
 	{
 		olc::vf2d vScreenSpacePos =
@@ -2351,7 +5229,7 @@ namespace olc
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
 		di.w = { 1,1,1,1 };
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
 	}
 
 	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, olc::Decal* decal, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
@@ -2378,7 +5256,7 @@ namespace olc
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
 		di.w = { 1,1,1,1 };
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
 	}
 
 
@@ -2404,9 +5282,42 @@ namespace olc
 		di.uv = { { 0.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f} };
 		di.w = { 1, 1, 1, 1 };
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
+	}
+
+	void PixelGameEngine::DrawDecal(const olc::vf2d& pos, const olc::DecalRegion& region, const olc::vf2d& scale, const olc::Pixel& tint)
+	{
+		olc::vf2d vScreenSpacePos =
+		{
+			(std::floor(pos.x) * vInvScreenSize.x) * 2.0f - 1.0f,
+			((std::floor(pos.y) * vInvScreenSize.y) * 2.0f - 1.0f) * -1.0f
+		};
+
+		olc::vf2d vScreenSpaceDim =
+		{
+			vScreenSpacePos.x + (2.0f * (region.vSize.x * vInvScreenSize.x)) * scale.x,
+			vScreenSpacePos.y - (2.0f * (region.vSize.y * vInvScreenSize.y)) * scale.y
+		};
+
+		DecalInstance di;
+		di.decal = region.decal;
+		di.points = 4;
+		di.tint = { tint, tint, tint, tint };
+		di.pos = { { vScreenSpacePos.x, vScreenSpacePos.y }, { vScreenSpacePos.x, vScreenSpaceDim.y }, { vScreenSpaceDim.x, vScreenSpaceDim.y }, { vScreenSpaceDim.x, vScreenSpacePos.y } };
+		olc::vf2d uvtl = region.vUVPos;
+		olc::vf2d uvbr = region.vUVPos + region.vUVSize;
+		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
+		di.w = { 1, 1, 1, 1 };
+		di.mode = nDecalMode;
+		olc_SubmitDecal(di);
 	}
 
+	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, const olc::DecalRegion& region, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::vf2d& scale, const olc::Pixel& tint)
+	{ DrawPartialDecal(pos, region.decal, region.vPos + source_pos, source_size, scale, tint); }
+
+	void PixelGameEngine::DrawPartialDecal(const olc::vf2d& pos, const olc::vf2d& size, const olc::DecalRegion& region, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
+	{ DrawPartialDecal(pos, size, region.decal, region.vPos + source_pos, source_size, tint); }
+
 	void PixelGameEngine::DrawExplicitDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d* uv, const olc::Pixel* col, uint32_t elements)
 	{
 		DecalInstance di;
@@ -2424,7 +5335,7 @@ namespace olc
 			di.w[i] = 1.0f;
 		}
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
 	}
 
 	void PixelGameEngine::DrawPolygonDecal(olc::Decal* decal, const std::vector<olc::vf2d>& pos, const std::vector<olc::vf2d>& uv, const olc::Pixel tint)
@@ -2444,7 +5355,7 @@ namespace olc
 			di.w[i] = 1.0f;
 		}
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
 	}
 
 	void PixelGameEngine::FillRectDecal(const olc::vf2d& pos, const olc::vf2d& size, const olc::Pixel col)
@@ -2485,7 +5396,7 @@ namespace olc
 			di.w[i] = 1;
 		}
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
 	}
 
 
@@ -2513,7 +5424,7 @@ namespace olc
 		olc::vf2d uvbr = uvtl + (source_size * decal->vUVScale);
 		di.uv = { { uvtl.x, uvtl.y }, { uvtl.x, uvbr.y }, { uvbr.x, uvbr.y }, { uvbr.x, uvtl.y } };
 		di.mode = nDecalMode;
-		vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+		olc_SubmitDecal(di);
 	}
 
 	void PixelGameEngine::DrawPartialWarpedDecal(olc::Decal* decal, const olc::vf2d* pos, const olc::vf2d& source_pos, const olc::vf2d& source_size, const olc::Pixel& tint)
@@ -2545,7 +5456,7 @@ namespace olc
 				di.pos[i] = { (pos[i].x * vInvScreenSize.x) * 2.0f - 1.0f, ((pos[i].y * vInvScreenSize.y) * 2.0f - 1.0f) * -1.0f };
 			}
 			di.mode = nDecalMode;
-			vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+			olc_SubmitDecal(di);
 		}
 	}
 
@@ -2576,7 +5487,7 @@ namespace olc
 				di.pos[i] = { (pos[i].x * vInvScreenSize.x) * 2.0f - 1.0f, ((pos[i].y * vInvScreenSize.y) * 2.0f - 1.0f) * -1.0f };
 			}
 			di.mode = nDecalMode;
-			vLayers[nTargetLayer].vecDecalInstance.push_back(di);
+			olc_SubmitDecal(di);
 		}
 	}
 
@@ -2764,6 +5675,7 @@ namespace olc
 	{
 		funcPixelMode = pixelMode;
 		nPixelMode = Pixel::Mode::CUSTOM;
+		nPixelModeVersion++;
 	}
 
 	void PixelGameEngine::SetPixelBlend(float fBlend)
@@ -2773,6 +5685,136 @@ namespace olc
 		if (fBlendFactor > 1.0f) fBlendFactor = 1.0f;
 	}
 
+	void PixelGameEngine::SetDeferredDrawing(bool bEnable, uint32_t nThreads)
+	{
+		FlushDeferred();
+		bDeferred = bEnable;
+		pDeferredPool.reset();
+		if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+		// The thread flushing works along with the pool
+		if (bEnable && nThreads > 1)
+			pDeferredPool = std::make_unique<olc::ThreadPool>(nThreads - 1);
+	}
+
+	bool PixelGameEngine::IsDeferredDrawing() const
+	{ return bDeferred; }
+
+	bool PixelGameEngine::olc_Defer(DrawCommand::Type type, const Pixel& p, const olc::vi2d& vMin, const olc::vi2d& vMax, std::initializer_list<int32_t> args, olc::Sprite* sprite, uint32_t scale, uint8_t flip, std::initializer_list<float> fargs)
+	{
+		if (!bDeferred || tlsDeferredTile || pDrawTarget == nullptr) return false;
+
+		DrawCommand cmd;
+		cmd.vMin = vMin.max({ 0, 0 });
+		cmd.vMax = vMax.min({ pDrawTarget->width, pDrawTarget->height });
+		// Entirely off the draw target, immediate mode would not draw it either
+		if (cmd.vMin.x >= cmd.vMax.x || cmd.vMin.y >= cmd.vMax.y) return true;
+
+		cmd.type = type;
+		cmd.p = p;
+		std::copy(args.begin(), args.end(), cmd.v);
+		std::copy(fargs.begin(), fargs.end(), cmd.f);
+		cmd.sprite = sprite;
+		cmd.scale = scale;
+		cmd.flip = flip;
+		cmd.nMode = nPixelMode;
+		cmd.fBlend = fBlendFactor;
+		if (nPixelMode == Pixel::CUSTOM)
+		{
+			// Commands share a copy of the custom function until it is replaced
+			if (vDeferredPixelFuncs.empty() || nDeferredPixelModeVersion != nPixelModeVersion)
+			{
+				vDeferredPixelFuncs.push_back(funcPixelMode);
+				nDeferredPixelModeVersion = nPixelModeVersion;
+			}
+			cmd.nPixelFunc = uint32_t(vDeferredPixelFuncs.size()) - 1;
+		}
+		vDeferred.push_back(cmd);
+		return true;
+	}
+
+	void PixelGameEngine::olc_GetClip(olc::vi2d& vMin, olc::vi2d& vMax) const
+	{
+		if (tlsDeferredTile)
+		{
+			vMin = tlsDeferredTile->vMin;
+			vMax = tlsDeferredTile->vMax;
+		}
+		else
+		{
+			vMin = { 0, 0 };
+			vMax = { GetDrawTargetWidth(), GetDrawTargetHeight() };
+		}
+	}
+
+	void PixelGameEngine::FlushDeferred()
+	{
+		if (vDeferred.empty()) return;
+
+		// Taken out first, so drawing from the tiles below does not record again
+		std::vector<DrawCommand> vCommands;
+		vCommands.swap(vDeferred);
+
+		// Bin each command into the tiles its area overlaps, in recorded order
+		const int32_t nTileSize = 64;
+		const int32_t nTilesX = (pDrawTarget->width + nTileSize - 1) / nTileSize;
+		const int32_t nTilesY = (pDrawTarget->height + nTileSize - 1) / nTileSize;
+		vDeferredTiles.resize(size_t(nTilesX) * size_t(nTilesY));
+		for (auto& tile : vDeferredTiles) tile.clear();
+		for (uint32_t i = 0; i < uint32_t(vCommands.size()); i++)
+		{
+			const DrawCommand& cmd = vCommands[i];
+			for (int32_t ty = cmd.vMin.y / nTileSize; ty <= (cmd.vMax.y - 1) / nTileSize; ty++)
+				for (int32_t tx = cmd.vMin.x / nTileSize; tx <= (cmd.vMax.x - 1) / nTileSize; tx++)
+					vDeferredTiles[size_t(ty) * nTilesX + tx].push_back(i);
+		}
+
+		std::vector<uint32_t> vBusyTiles;
+		for (uint32_t t = 0; t < uint32_t(vDeferredTiles.size()); t++)
+			if (!vDeferredTiles[t].empty()) vBusyTiles.push_back(t);
+
+		// Each tile replays its commands through the immediate mode code, clipped
+		// to the tile. Tiles share no pixels so they need no synchronisation.
+		auto RasterizeTile = [&](uint32_t n)
+		{
+			const uint32_t t = vBusyTiles[n];
+			DeferredTile tile;
+			tile.vMin = { int32_t(t % nTilesX) * nTileSize, int32_t(t / nTilesX) * nTileSize };
+			tile.vMax = (tile.vMin + olc::vi2d(nTileSize, nTileSize)).min({ pDrawTarget->width, pDrawTarget->height });
+			tlsDeferredTile = &tile;
+			for (uint32_t i : vDeferredTiles[t])
+			{
+				const DrawCommand& cmd = vCommands[i];
+				tile.nMode = cmd.nMode;
+				tile.fBlend = cmd.fBlend;
+				tile.pFunc = cmd.nMode == Pixel::CUSTOM ? &vDeferredPixelFuncs[cmd.nPixelFunc] : nullptr;
+				const int32_t* v = cmd.v;
+				switch (cmd.type)
+				{
+				case DrawCommand::Type::CLEAR: Clear(cmd.p); break;
+				case DrawCommand::Type::FILL_RECT: FillRect(v[0], v[1], v[2], v[3], cmd.p); break;
+				case DrawCommand::Type::FILL_CIRCLE: FillCircle(v[0], v[1], v[2], cmd.p); break;
+				case DrawCommand::Type::FILL_TRIANGLE: FillTriangle(v[0], v[1], v[2], v[3], v[4], v[5], cmd.p); break;
+				case DrawCommand::Type::DRAW_SPRITE: DrawSprite(v[0], v[1], cmd.sprite, cmd.scale, cmd.flip); break;
+				case DrawCommand::Type::DRAW_PARTIAL_SPRITE: DrawPartialSprite(v[0], v[1], cmd.sprite, v[2], v[3], v[4], v[5], cmd.scale, cmd.flip); break;
+				case DrawCommand::Type::DRAW_TRANSFORMED:
+					DrawSpriteTransformed(cmd.sprite, { cmd.f[0], cmd.f[1] }, { cmd.f[2], cmd.f[3] }, { cmd.f[4], cmd.f[5] }, cmd.flip != 0);
+					break;
+				}
+			}
+			tlsDeferredTile = nullptr;
+		};
+
+		if (pDeferredPool && vBusyTiles.size() > 1)
+			pDeferredPool->ParallelFor(uint32_t(vBusyTiles.size()), RasterizeTile);
+		else
+			for (uint32_t n = 0; n < uint32_t(vBusyTiles.size()); n++) RasterizeTile(n);
+
+		// Keep the allocation for the next frame
+		vCommands.clear();
+		vDeferred.swap(vCommands);
+		vDeferredPixelFuncs.clear();
+	}
+
 	// User must override these functions as required. I have not made
 	// them abstract because I do need a default behaviour to occur if
 	// they are not overwritten
@@ -2814,15 +5856,30 @@ namespace olc
 
 	void PixelGameEngine::olc_UpdateWindowSize(int32_t x, int32_t y)
 	{
+		std::lock_guard<std::mutex> lock(muxInput);
 		vWindowSize = { x, y };
 		olc_UpdateViewport();
 	}
 
+	void PixelGameEngine::olc_LatchWindowState()
+	{
+		// Called with muxInput held
+		vFrameWindowSize = vWindowSize;
+		vFrameScreenPixelSize = vScreenPixelSize;
+		vFrameMouseWindowPos = vMouseWindowPos;
+		bFrameInputFocus = bHasInputFocus;
+		bFrameMouseFocus = bHasMouseFocus;
+	}
+
 	void PixelGameEngine::olc_UpdateMouseWheel(int32_t delta)
-	{ nMouseWheelDeltaCache += delta; }
+	{
+		std::lock_guard<std::mutex> lock(muxInput);
+		nMouseWheelDeltaCache += delta;
+	}
 
 	void PixelGameEngine::olc_UpdateMouse(int32_t x, int32_t y)
 	{
+		std::lock_guard<std::mutex> lock(muxInput);
 		// Mouse coords come in screen space
 		// But leave in pixel space
 		bHasMouseFocus = true;
@@ -2839,16 +5896,32 @@ namespace olc
 	}
 
 	void PixelGameEngine::olc_UpdateMouseState(int32_t button, bool state)
-	{ pMouseNewState[button] = state; }
+	{
+		std::lock_guard<std::mutex> lock(muxInput);
+		if (pMouseNewState[button] == state) return;
+		pMouseNewState[button] = state;
+		vInputQueue.push_back({ InputEvent::Device::MOUSE, uint32_t(button), state });
+	}
 
 	void PixelGameEngine::olc_UpdateKeyState(int32_t key, bool state)
-	{ pKeyNewState[key] = state; }
+	{
+		std::lock_guard<std::mutex> lock(muxInput);
+		if (pKeyNewState[key] == state) return;
+		pKeyNewState[key] = state;
+		vInputQueue.push_back({ InputEvent::Device::KEYBOARD, uint32_t(key), state });
+	}
 
 	void PixelGameEngine::olc_UpdateMouseFocus(bool state)
-	{ bHasMouseFocus = state; }
+	{
+		std::lock_guard<std::mutex> lock(muxInput);
+		bHasMouseFocus = state;
+	}
 
 	void PixelGameEngine::olc_UpdateKeyFocus(bool state)
-	{ bHasInputFocus = state; }
+	{
+		std::lock_guard<std::mutex> lock(muxInput);
+		bHasInputFocus = state;
+	}
 
 	void PixelGameEngine::olc_Reanimate()
 	{ bAtomActive = true; }
@@ -2876,7 +5949,10 @@ namespace olc
 		while (bAtomActive)
 		{
 			// Run as fast as possible
-			while (bAtomActive) { olc_CoreUpdate(); }
+			if (bPipelined)
+				olc_RunPipelined();
+			else
+				while (bAtomActive) { olc_CoreUpdate(); olc_PaceFrame(); }
 
 			// Allow the user to free resources if they have overrided the destroy function
 			if (!OnUserDestroy())
@@ -2886,6 +5962,7 @@ namespace olc
 			}
 		}
 
+		StopRecording();
 		platform->ThreadCleanUp();
 	}
 
@@ -2903,56 +5980,158 @@ namespace olc
 		vLayers[0].bShow = true;
 		SetDrawTarget(nullptr);
 
-		m_tp1 = std::chrono::system_clock::now();
-		m_tp2 = std::chrono::system_clock::now();
+		{
+			std::lock_guard<std::mutex> lock(muxInput);
+			olc_LatchWindowState();
+		}
+
+		m_tp1 = std::chrono::steady_clock::now();
+		m_tp2 = m_tp1;
+		nFrameTimeNs = 0;
+		nSessionTimeNs = 0;
+		nFrameIndex = 0;
 	}
 
 
+	void PixelGameEngine::olc_PaceFrame()
+	{
+		using clock = std::chrono::steady_clock;
+		float fRate = bIdle ? fIdleFrameRate : fFrameRateLimit;
+		if (fRate <= 0.0f) return;
+
+		const auto nPeriod = std::chrono::nanoseconds(int64_t(1e9 / double(fRate)));
+		auto tpNow = clock::now();
+
+		// Deadlines follow on from each other so the rate does not drift, unless
+		// we fell a whole frame behind or the rate changed, then start afresh
+		tpFrameDeadline += nPeriod;
+		if (tpFrameDeadline < tpNow - nPeriod || tpFrameDeadline > tpNow + nPeriod)
+			tpFrameDeadline = tpNow + nPeriod;
+
+		// The OS may wake us late, so sleep short and spin the margin off. The
+		// margin follows the worst recent oversleep, growing fast and shrinking
+		// slowly. Idle frames need no precision and only sleep.
+		auto tpWake = bIdle ? tpFrameDeadline : tpFrameDeadline - nSpinMargin;
+		if (tpWake > tpNow)
+		{
+			std::this_thread::sleep_until(tpWake);
+			if (!bIdle)
+			{
+				auto nOversleep = clock::now() - tpWake;
+				nSpinMargin = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(nOversleep + nOversleep / 4), nSpinMargin - nSpinMargin / 16);
+				nSpinMargin = std::clamp(nSpinMargin, std::chrono::nanoseconds(std::chrono::microseconds(50)), std::chrono::nanoseconds(std::chrono::milliseconds(4)));
+			}
+		}
+		while (clock::now() < tpFrameDeadline)
+			std::this_thread::yield();
+	}
+
 	void PixelGameEngine::olc_CoreUpdate()
 	{
-		// Handle Timing
-		m_tp2 = std::chrono::system_clock::now();
-		std::chrono::duration<float> elapsedTime = m_tp2 - m_tp1;
+		olc_UpdateFrame();
+		olc_RenderFrame(vLayers);
+		if (!sPendingTitle.empty())
+		{
+			platform->SetWindowTitle(sPendingTitle);
+			sPendingTitle.clear();
+		}
+	}
+
+	void PixelGameEngine::olc_UpdateFrame()
+	{
+		// Handle Timing, on a monotonic clock in whole nanoseconds so wall clock
+		// adjustments cannot upset it and long sessions keep their precision
+		m_tp2 = std::chrono::steady_clock::now();
+		nFrameTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_tp2 - m_tp1).count();
 		m_tp1 = m_tp2;
+		if (pReplayFrame) nFrameTimeNs = pReplayFrame->nFrameTimeNs;
+		nSessionTimeNs += nFrameTimeNs;
+
+		// Frame statistics, start to start so they include any pacing
+		if (nFrameIndex > 0)
+			vFrameIntervals[nFrameIntervals++ % vFrameIntervals.size()] = nFrameTimeNs;
 
 		// Our time per frame coefficient
-		float fElapsedTime = elapsedTime.count();
+		float fElapsedTime = float(double(nFrameTimeNs) * 1e-9);
 		fLastElapsed = fElapsedTime;
 
-		// Some platforms will need to check for events
-		platform->HandleSystemEvent();
+		// Some platforms will need to check for events, when pipelined the
+		// render thread does so as it owns the window
+		if (!pipeline || !pipeline->IsRunning())
+			platform->HandleSystemEvent();
+
+		// A replay queues the input it was recorded with
+		if (pReplayFrame)
+		{
+			for (const auto& e : pReplayFrame->vInput)
+			{
+				if (e.device == InputEvent::Device::KEYBOARD) olc_UpdateKeyState(int32_t(e.nCode), e.bPressed);
+				else olc_UpdateMouseState(int32_t(e.nCode), e.bPressed);
+			}
+		}
 
-		// Compare hardware input states from previous frame
-		auto ScanHardware = [&](HWButton* pKeys, bool* pStateOld, bool* pStateNew, uint32_t nKeyCount)
+		// Compare hardware input states from previous frame, only for the keys
+		// and buttons queued as changed. The flags set last frame are cleared.
+		for (HWButton* pButton : vInputFlagged)
 		{
-			for (uint32_t i = 0; i < nKeyCount; i++)
+			pButton->bPressed = false;
+			pButton->bReleased = false;
+		}
+		vInputFlagged.clear();
+		vInputEvents.clear();
+		{
+			std::lock_guard<std::mutex> lock(muxInput);
+			if (pReplayFrame)
+			{
+				vMousePosCache = pReplayFrame->vMousePos;
+				nMouseWheelDeltaCache = pReplayFrame->nMouseWheelDelta;
+				bHasInputFocus = pReplayFrame->bInputFocus;
+				bHasMouseFocus = pReplayFrame->bMouseFocus;
+			}
+
+			// Cache mouse coordinates so they remain consistent during frame
+			vMousePos = vMousePosCache;
+			nMouseWheelDelta = nMouseWheelDeltaCache;
+			nMouseWheelDeltaCache = 0;
+			olc_LatchWindowState();
+
+			vInputScan.swap(vInputQueue);
+			for (const auto& e : vInputScan)
 			{
-				pKeys[i].bPressed = false;
-				pKeys[i].bReleased = false;
-				if (pStateNew[i] != pStateOld[i])
+				const bool bKey = e.device == InputEvent::Device::KEYBOARD;
+				HWButton& button = bKey ? pKeyboardState[e.nCode] : pMouseState[e.nCode];
+				bool& bOld = bKey ? pKeyOldState[e.nCode] : pMouseOldState[e.nCode];
+				const bool bNew = bKey ? pKeyNewState[e.nCode] : pMouseNewState[e.nCode];
+				// Pressed and released again since the last frame, nothing to see
+				if (bNew == bOld) continue;
+				if (bNew)
 				{
-					if (pStateNew[i])
-					{
-						pKeys[i].bPressed = !pKeys[i].bHeld;
-						pKeys[i].bHeld = true;
-					}
-					else
-					{
-						pKeys[i].bReleased = true;
-						pKeys[i].bHeld = false;
-					}
+					button.bPressed = !button.bHeld;
+					button.bHeld = true;
+				}
+				else
+				{
+					button.bReleased = true;
+					button.bHeld = false;
 				}
-				pStateOld[i] = pStateNew[i];
+				bOld = bNew;
+				vInputFlagged.push_back(&button);
+				vInputEvents.push_back({ e.device, e.nCode, bNew });
 			}
-		};
-
-		ScanHardware(pKeyboardState, pKeyOldState, pKeyNewState, 256);
-		ScanHardware(pMouseState, pMouseOldState, pMouseNewState, nMouseButtons);
+		}
+		vInputScan.clear();
 
-		// Cache mouse coordinates so they remain consistent during frame
-		vMousePos = vMousePosCache;
-		nMouseWheelDelta = nMouseWheelDeltaCache;
-		nMouseWheelDeltaCache = 0;
+		if (pRecording && !pReplayFrame)
+		{
+			olc::SessionFrame frame;
+			frame.nFrameTimeNs = nFrameTimeNs;
+			frame.vInput = vInputEvents;
+			frame.vMousePos = vMousePos;
+			frame.nMouseWheelDelta = nMouseWheelDelta;
+			frame.bInputFocus = bFrameInputFocus;
+			frame.bMouseFocus = bFrameMouseFocus;
+			pRecording->Write(frame);
+		}
 
 		//	renderer->ClearBuffer(olc::BLACK, true);
 
@@ -2961,17 +6140,41 @@ namespace olc
 		if (!OnUserUpdate(fElapsedTime)) bAtomActive = false;
 		for (auto& ext : vExtensions) ext->OnAfterUserUpdate(fElapsedTime);
 
-		// Display Frame
-		renderer->UpdateViewport(vViewPos, vViewSize);
-		renderer->ClearBuffer(olc::BLACK, true);
+		// Anything still recorded must be in the layers before they are shown
+		FlushDeferred();
+
+		// Sorted here rather than when rendering, which may be on another thread
+		for (auto& layer : vLayers)
+			if (layer.bSortDecals) olc_SortDecals(layer.vecDecalInstance);
 
 		// Layer 0 must always exist
 		vLayers[0].bUpdate = true;
 		vLayers[0].bShow = true;
 		SetDecalMode(DecalMode::NORMAL);
+		SetDecalSortLayer(0);
+
+		// Update Title Bar
+		fFrameTimer += fElapsedTime;
+		nFrameCount++;
+		if (fFrameTimer >= 1.0f)
+		{
+			nLastFPS = nFrameCount;
+			fFrameTimer -= 1.0f;
+			sPendingTitle = "OneLoneCoder.com - Pixel Game Engine - " + sAppName + " - FPS: " + std::to_string(nFrameCount);
+			nFrameCount = 0;
+		}
+
+		nFrameIndex++;
+	}
+
+	void PixelGameEngine::olc_RenderFrame(std::vector<LayerDesc>& vRenderLayers)
+	{
+		// Display Frame
+		renderer->UpdateViewport(vViewPos, vViewSize);
+		renderer->ClearBuffer(olc::BLACK, true);
 		renderer->PrepareDrawing();
 
-		for (auto layer = vLayers.rbegin(); layer != vLayers.rend(); ++layer)
+		for (auto layer = vRenderLayers.rbegin(); layer != vRenderLayers.rend(); ++layer)
 		{
 			if (layer->bShow)
 			{
@@ -3001,18 +6204,80 @@ namespace olc
 
 		// Present Graphics to screen
 		renderer->DisplayFrame();
+	}
 
-		// Update Title Bar
-		fFrameTimer += fElapsedTime;
-		nFrameCount++;
-		if (fFrameTimer >= 1.0f)
+	void PixelGameEngine::olc_SubmitFrame()
+	{
+		// Layers redrawn this frame are copied, so the update may draw into
+		// them again straight away, and decal lists change hands
+		FramePipeline::Packet* packet = pipeline->BeginPacket();
+		packet->vLayers.resize(vLayers.size());
+		packet->vLayerPixels.resize(vLayers.size());
+		for (size_t i = 0; i < vLayers.size(); i++)
+		{
+			LayerDesc& src = vLayers[i];
+			LayerDesc& dst = packet->vLayers[i];
+			dst.vOffset = src.vOffset;
+			dst.vScale = src.vScale;
+			dst.bShow = src.bShow;
+			dst.nResID = src.nResID;
+			dst.tint = src.tint;
+			dst.funcHook = src.funcHook;
+			dst.bUpdate = src.bShow && src.funcHook == nullptr && src.bUpdate;
+			if (dst.bUpdate)
+			{
+				auto& pixels = packet->vLayerPixels[i];
+				if (!pixels || pixels->width != src.pDrawTarget->width || pixels->height != src.pDrawTarget->height)
+				{
+					pixels = std::make_unique<olc::Sprite>();
+					pixels->width = src.pDrawTarget->width;
+					pixels->height = src.pDrawTarget->height;
+					pixels->pColData.allocate_uninitialised(src.pDrawTarget->pColData.size());
+				}
+				std::memcpy(pixels->pColData.data(), src.pDrawTarget->pColData.data(), src.pDrawTarget->pColData.size() * sizeof(olc::Pixel));
+				src.bUpdate = false;
+			}
+			dst.pDrawTarget = packet->vLayerPixels[i].get();
+			dst.vecDecalInstance.clear();
+			dst.vecDecalInstance.swap(src.vecDecalInstance);
+		}
+		packet->sWindowTitle.swap(sPendingTitle);
+		sPendingTitle.clear();
+		pipeline->SubmitPacket(packet);
+	}
+
+	void PixelGameEngine::olc_RunPipelined()
+	{
+		if (!pipeline) pipeline = std::make_unique<FramePipeline>();
+		pipeline->Start(nPipelineBuffers);
+
+		std::thread tUpdate([&]()
 		{
-			nLastFPS = nFrameCount;
-			fFrameTimer -= 1.0f;
-			std::string sTitle = "OneLoneCoder.com - Pixel Game Engine - " + sAppName + " - FPS: " + std::to_string(nFrameCount);
-			platform->SetWindowTitle(sTitle);
-			nFrameCount = 0;
+			while (bAtomActive)
+			{
+				olc_UpdateFrame();
+				olc_SubmitFrame();
+				olc_PaceFrame();
+			}
+			pipeline->Finish();
+		});
+
+		// This thread owns the window and graphics context, it keeps the window
+		// responsive even while the update is slow
+		bool bDone = false;
+		while (!bDone)
+		{
+			platform->HandleSystemEvent();
+			if (FramePipeline::Packet* packet = pipeline->NextPacket(std::chrono::milliseconds(4), bDone))
+			{
+				olc_RenderFrame(packet->vLayers);
+				if (!packet->sWindowTitle.empty()) platform->SetWindowTitle(packet->sWindowTitle);
+				pipeline->ReleasePacket(packet);
+			}
 		}
+
+		tUpdate.join();
+		pipeline->Stop();
 	}
 
 	void PixelGameEngine::olc_ConstructFontSheet()
@@ -3077,8 +6342,272 @@ namespace olc
 	PGEX::PGEX(bool bHook) { if(bHook) pge->pgex_Register(this); }
 	void PGEX::OnBeforeUserCreate() {}
 	void PGEX::OnAfterUserCreate()	{}
-	void PGEX::OnBeforeUserUpdate(float& fElapsedTime) {}
-	void PGEX::OnAfterUserUpdate(float fElapsedTime) {}
+	void PGEX::OnBeforeUserUpdate(float&) {}
+	void PGEX::OnAfterUserUpdate(float) {}
+
+	// O------------------------------------------------------------------------------O
+	// | olc::AssetWatcher IMPLEMENTATION                                             |
+	// O------------------------------------------------------------------------------O
+	AssetWatcher::AssetWatcher(bool bPolling, uint32_t nPollMs) : PGEX(true), nPollMs(std::max(nPollMs, 1u))
+	{
+#if defined(__linux__)
+		if (!bPolling)
+		{
+			nInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (nInotify >= 0 && pipe(nWake) != 0)
+			{
+				close(nInotify);
+				nInotify = -1;
+			}
+		}
+#endif
+		this->bPolling = nInotify < 0;
+		thread = std::thread(&AssetWatcher::WatcherThread, this);
+	}
+
+	AssetWatcher::~AssetWatcher()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			bStop = true;
+		}
+		cvStop.notify_all();
+#if defined(__linux__)
+		if (nWake[1] >= 0) { char c = 0; if (write(nWake[1], &c, 1) < 0) {} }
+#endif
+		thread.join();
+#if defined(__linux__)
+		if (nInotify >= 0) close(nInotify);
+		if (nWake[0] >= 0) close(nWake[0]);
+		if (nWake[1] >= 0) close(nWake[1]);
+#endif
+	}
+
+	void AssetWatcher::Watch(olc::Renderable& r, const std::string& sFile, bool filter, bool clamp)
+	{
+		sEntry entry;
+		entry.pRenderable = &r;
+		entry.sFile = sFile;
+		entry.filter = filter;
+		entry.clamp = clamp;
+		if (r.Sprite() != nullptr)
+		{
+			entry.format = r.Sprite()->GetFormat();
+			entry.layout = r.Sprite()->GetLayout();
+		}
+		Add(std::move(entry));
+	}
+
+	void AssetWatcher::Watch(olc::Sprite* spr, olc::Decal* decal, const std::string& sFile)
+	{
+		if (spr == nullptr) return;
+		sEntry entry;
+		entry.pSprite = spr;
+		entry.pDecal = decal;
+		entry.sFile = sFile;
+		entry.format = spr->GetFormat();
+		entry.layout = spr->GetLayout();
+		Add(std::move(entry));
+	}
+
+	void AssetWatcher::Add(sEntry entry)
+	{
+		_gfs::path path = _gfs::path(entry.sFile).lexically_normal();
+		entry.sDirectory = path.has_parent_path() ? path.parent_path().string() : std::string(".");
+		entry.sName = path.filename().string();
+		entry.nTime = FileTime(entry.sFile);
+
+		std::unique_lock<std::mutex> lock(mtx);
+#if defined(__linux__)
+		if (!bPolling)
+		{
+			// One watch per directory, adding it again returns the same descriptor
+			int wd = inotify_add_watch(nInotify, entry.sDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+			if (wd >= 0) mapDirectories[wd] = entry.sDirectory;
+		}
+#endif
+		mapEntries[nNextEntry++] = std::move(entry);
+	}
+
+	void AssetWatcher::Unwatch(const olc::Renderable& r)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		for (auto i = mapEntries.begin(); i != mapEntries.end();)
+			i = i->second.pRenderable == &r ? mapEntries.erase(i) : std::next(i);
+	}
+
+	void AssetWatcher::Unwatch(const olc::Sprite* spr)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		for (auto i = mapEntries.begin(); i != mapEntries.end();)
+			i = i->second.pSprite == spr ? mapEntries.erase(i) : std::next(i);
+	}
+
+	void AssetWatcher::SetOnReload(std::function<void(const olc::AssetWatcher::Reload&)> func)
+	{ funcOnReload = func; }
+
+	bool AssetWatcher::IsPolling() const
+	{ return bPolling; }
+
+	void AssetWatcher::OnBeforeUserUpdate(float&)
+	{ Apply(); }
+
+	uint32_t AssetWatcher::Apply()
+	{
+		std::vector<sDecoded> vReady;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			if (vDecoded.empty()) return 0;
+			vReady.swap(vDecoded);
+		}
+
+		uint32_t nSwapped = 0;
+		for (auto& d : vReady)
+		{
+			sEntry entry;
+			{
+				std::unique_lock<std::mutex> lock(mtx);
+				auto i = mapEntries.find(d.nEntry);
+				if (i == mapEntries.end()) continue; // Unwatched meanwhile
+				entry = i->second;
+			}
+
+			if (d.pSprite)
+			{
+				if (entry.pRenderable != nullptr && !entry.pRenderable->pSprite)
+				{
+					entry.pRenderable->pSprite = std::move(d.pSprite);
+					entry.pRenderable->pDecal = std::make_unique<olc::Decal>(entry.pRenderable->pSprite.get(), entry.filter, entry.clamp);
+				}
+				else
+				{
+					olc::Sprite* spr = entry.pRenderable ? entry.pRenderable->Sprite() : entry.pSprite;
+					olc::Decal* decal = entry.pRenderable ? entry.pRenderable->Decal() : entry.pDecal;
+					spr->Swap(*d.pSprite);
+					if (decal != nullptr) decal->Update();
+				}
+				nSwapped++;
+			}
+
+			d.reload.fLatencyMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - d.tpSeen).count();
+			if (funcOnReload) funcOnReload(d.reload);
+		}
+		// The replaced images are freed here, on leaving
+		return nSwapped;
+	}
+
+	int64_t AssetWatcher::FileTime(const std::string& sFile)
+	{
+		std::error_code ec;
+		auto t = _gfs::last_write_time(sFile, ec);
+		return ec ? 0 : int64_t(t.time_since_epoch().count());
+	}
+
+	void AssetWatcher::Decode(const std::vector<uint64_t>& vEntries, std::chrono::steady_clock::time_point tpSeen)
+	{
+		for (uint64_t nEntry : vEntries)
+		{
+			sEntry entry;
+			{
+				std::unique_lock<std::mutex> lock(mtx);
+				auto i = mapEntries.find(nEntry);
+				if (i == mapEntries.end()) continue;
+				entry = i->second;
+			}
+
+			sDecoded d;
+			d.nEntry = nEntry;
+			d.tpSeen = tpSeen;
+			d.reload.sFile = entry.sFile;
+			auto tp1 = std::chrono::steady_clock::now();
+			auto spr = std::make_unique<olc::Sprite>();
+			d.reload.result = spr->LoadFromFile(entry.sFile);
+			if (d.reload.result == olc::rcode::OK)
+			{
+				// Matched to the sprite it replaces, so the swap is all the engine does
+				if (entry.format != olc::Sprite::Format::RGBA8) spr.reset(spr->Convert(entry.format));
+				spr->SetLayout(entry.layout);
+				d.pSprite = std::move(spr);
+			}
+			d.reload.fDecodeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - tp1).count();
+
+			std::unique_lock<std::mutex> lock(mtx);
+			vDecoded.push_back(std::move(d));
+		}
+	}
+
+	void AssetWatcher::WatcherThread()
+	{
+#if defined(__linux__)
+		if (!bPolling)
+		{
+			std::vector<char> vBuffer(64 * 1024);
+			while (true)
+			{
+				pollfd fds[2] = { { nInotify, POLLIN, 0 }, { nWake[0], POLLIN, 0 } };
+				if (poll(fds, 2, -1) < 0 && errno != EINTR) break;
+				if (fds[1].revents != 0) break;
+
+				// Several events for one file, as a save usually gives, decode it once
+				std::vector<std::pair<int, std::string>> vChanged;
+				ssize_t nRead;
+				while ((nRead = read(nInotify, vBuffer.data(), vBuffer.size())) > 0)
+				{
+					for (ssize_t i = 0; i < nRead;)
+					{
+						const inotify_event* e = reinterpret_cast<const inotify_event*>(vBuffer.data() + i);
+						if (e->len > 0) vChanged.emplace_back(e->wd, std::string(e->name));
+						i += sizeof(inotify_event) + e->len;
+					}
+				}
+				if (vChanged.empty()) continue;
+				auto tpSeen = std::chrono::steady_clock::now();
+
+				std::vector<uint64_t> vEntries;
+				{
+					std::unique_lock<std::mutex> lock(mtx);
+					for (auto& entry : mapEntries)
+					{
+						for (auto& c : vChanged)
+						{
+							auto dir = mapDirectories.find(c.first);
+							if (dir != mapDirectories.end() && dir->second == entry.second.sDirectory && c.second == entry.second.sName)
+							{
+								vEntries.push_back(entry.first);
+								break;
+							}
+						}
+					}
+				}
+				Decode(vEntries, tpSeen);
+			}
+			return;
+		}
+#endif
+
+		std::unique_lock<std::mutex> lock(mtx);
+		while (!bStop)
+		{
+			cvStop.wait_for(lock, std::chrono::milliseconds(nPollMs));
+			if (bStop) break;
+
+			std::vector<uint64_t> vEntries;
+			for (auto& entry : mapEntries)
+			{
+				int64_t nTime = FileTime(entry.second.sFile);
+				if (nTime != 0 && nTime != entry.second.nTime)
+				{
+					entry.second.nTime = nTime;
+					vEntries.push_back(entry.first);
+				}
+			}
+			if (vEntries.empty()) continue;
+			auto tpSeen = std::chrono::steady_clock::now();
+			lock.unlock();
+			Decode(vEntries, tpSeen);
+			lock.lock();
+		}
+	}
 
 	// Need a couple of statics as these are singleton instances
 	// read from multiple locations
@@ -3087,6 +6616,8 @@ namespace olc
 	olc::PixelGameEngine* olc::Platform::ptrPGE = nullptr;
 	olc::PixelGameEngine* olc::Renderer::ptrPGE = nullptr;
 	std::unique_ptr<ImageLoader> olc::Sprite::loader = nullptr;
+	std::string olc::Sprite::sCacheDirectory;
+	olc::ResourceCodec olc::Sprite::cacheCodec = olc::ResourceCodec::RAW;
 };
 #pragma endregion 
 
@@ -3148,6 +6679,17 @@ namespace olc
 
 		bool bSync = false;
 		olc::DecalMode nDecalMode = olc::DecalMode(-1); // Thanks Gusgo & Bispoo
+		// Consecutive decals from one texture, e.g. an olc::Atlas page, skip the rebind
+		uint32_t nBoundTexture = uint32_t(-1);
+
+		void BindTexture(uint32_t id)
+		{
+			if (id != nBoundTexture)
+			{
+				glBindTexture(GL_TEXTURE_2D, id);
+				nBoundTexture = id;
+			}
+		}
 
 #if defined(OLC_PLATFORM_X11)
 		X11::Display* olc_Display = nullptr;
@@ -3282,6 +6824,7 @@ namespace olc
 		{
 			glEnable(GL_BLEND);
 			nDecalMode = DecalMode::NORMAL;
+			nBoundTexture = uint32_t(-1);
 			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		}
 
@@ -3335,9 +6878,9 @@ namespace olc
 			SetDecalMode(decal.mode);
 
 			if (decal.decal == nullptr)
-				glBindTexture(GL_TEXTURE_2D, 0);
+				BindTexture(0);
 			else
-				glBindTexture(GL_TEXTURE_2D, decal.decal->id);
+				BindTexture(decal.decal->id);
 
 			if (nDecalMode == DecalMode::WIREFRAME)
 				glBegin(GL_LINE_LOOP);
@@ -3360,6 +6903,7 @@ namespace olc
 			uint32_t id = 0;
 			glGenTextures(1, &id);
 			glBindTexture(GL_TEXTURE_2D, id);
+			nBoundTexture = id;
 			if (filtered)
 			{
 				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -3389,23 +6933,57 @@ namespace olc
 		uint32_t DeleteTexture(const uint32_t id) override
 		{
 			glDeleteTextures(1, &id);
+			if (id == nBoundTexture) nBoundTexture = uint32_t(-1);
 			return id;
 		}
 
 		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
 		{
 			UNUSED(id);
+			if (spr->GetLayout() != olc::Sprite::Layout::LINEAR)
+			{
+				// GL takes rows, so upload a linear copy
+				std::unique_ptr<olc::Sprite> pLinear(spr->Duplicate());
+				pLinear->SetLayout(olc::Sprite::Layout::LINEAR);
+				UpdateTexture(id, pLinear.get());
+				return;
+			}
+			if (spr->GetFormat() != olc::Sprite::Format::RGBA8)
+			{
+				// No one or two channel textures in GL 1, so expand to RGBA8
+				std::vector<olc::Pixel> vPixels(size_t(spr->width) * size_t(spr->height));
+				olc::Sprite::ConvertPixels(spr->GetFormat(), spr->GetRawData(), olc::Sprite::Format::RGBA8, vPixels.data(), vPixels.size());
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, vPixels.data());
+				return;
+			}
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
 		void ReadTexture(uint32_t id, olc::Sprite* spr) override
 		{
+			if (spr->GetLayout() != olc::Sprite::Layout::LINEAR)
+			{
+				olc::Sprite linear(spr->width, spr->height, spr->GetFormat());
+				ReadTexture(id, &linear);
+				linear.SetLayout(olc::Sprite::Layout::TILED);
+				spr->pColData = std::move(linear.pColData);
+				return;
+			}
+			if (spr->GetFormat() != olc::Sprite::Format::RGBA8)
+			{
+				std::vector<olc::Pixel> vPixels(size_t(spr->width) * size_t(spr->height));
+				glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, vPixels.data());
+				olc::Sprite::ConvertPixels(olc::Sprite::Format::RGBA8, vPixels.data(), spr->GetFormat(), spr->GetRawData(), vPixels.size());
+				return;
+			}
 			glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
 		}
 
 		void ApplyTexture(uint32_t id) override
 		{
+			// Always binds, this also resyncs after a layer hook drew with GL
 			glBindTexture(GL_TEXTURE_2D, id);
+			nBoundTexture = id;
 		}
 
 		void ClearBuffer(olc::Pixel p, bool bDepth) override
@@ -3485,6 +7063,21 @@ namespace olc
 	#define OGL_LOAD(t, n) n;
 #endif
 
+// One and two channel texture formats, core since GL 3.0 but missing from
+// some GL 1.1 headers
+#if !defined(GL_RG)
+	#define GL_RG 0x8227
+#endif
+#if !defined(GL_R8)
+	#define GL_R8 0x8229
+#endif
+#if !defined(GL_RG8)
+	#define GL_RG8 0x822B
+#endif
+#if !defined(GL_R32F)
+	#define GL_R32F 0x822E
+#endif
+
 namespace olc
 {
 	typedef char GLchar;
@@ -3533,6 +7126,17 @@ namespace olc
 #endif
 		bool bSync = false;
 		olc::DecalMode nDecalMode = olc::DecalMode(-1); // Thanks Gusgo & Bispoo
+		// Consecutive decals from one texture, e.g. an olc::Atlas page, skip the rebind
+		uint32_t nBoundTexture = uint32_t(-1);
+
+		void BindTexture(uint32_t id)
+		{
+			if (id != nBoundTexture)
+			{
+				glBindTexture(GL_TEXTURE_2D, id);
+				nBoundTexture = id;
+			}
+		}
 #if defined(OLC_PLATFORM_X11)
 		X11::Display* olc_Display = nullptr;
 		X11::Window* olc_Window = nullptr;
@@ -3812,6 +7416,7 @@ namespace olc
 		{
 			glEnable(GL_BLEND);
 			nDecalMode = DecalMode::NORMAL;
+			nBoundTexture = uint32_t(-1);
 			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			locUseProgram(m_nQuadShader);
 			locBindVertexArray(m_vaQuad);
@@ -3859,9 +7464,9 @@ namespace olc
 		{
 			SetDecalMode(decal.mode);
 			if (decal.decal == nullptr)
-				glBindTexture(GL_TEXTURE_2D, rendBlankQuad.Decal()->id);
+				BindTexture(rendBlankQuad.Decal()->id);
 			else
-				glBindTexture(GL_TEXTURE_2D, decal.decal->id);
+				BindTexture(decal.decal->id);
 
 			locBindBuffer(0x8892, m_vbQuad);
 
@@ -3883,6 +7488,7 @@ namespace olc
 			uint32_t id = 0;
 			glGenTextures(1, &id);
 			glBindTexture(GL_TEXTURE_2D, id);
+			nBoundTexture = id;
 
 			if (filtered)
 			{
@@ -3914,23 +7520,80 @@ namespace olc
 		uint32_t DeleteTexture(const uint32_t id) override
 		{
 			glDeleteTextures(1, &id);
+			if (id == nBoundTexture) nBoundTexture = uint32_t(-1);
 			return id;
 		}
 
+		// Internal format, pixel format and type of a sprite format
+		static void GetTextureFormat(olc::Sprite::Format format, GLint& nInternal, GLenum& nFormat, GLenum& nType)
+		{
+			switch (format)
+			{
+			case olc::Sprite::Format::R8: nInternal = GL_R8; nFormat = GL_RED; nType = GL_UNSIGNED_BYTE; break;
+			case olc::Sprite::Format::RG8: nInternal = GL_RG8; nFormat = GL_RG; nType = GL_UNSIGNED_BYTE; break;
+			case olc::Sprite::Format::R32F: nInternal = GL_R32F; nFormat = GL_RED; nType = GL_FLOAT; break;
+			default: nInternal = GL_RGBA; nFormat = GL_RGBA; nType = GL_UNSIGNED_BYTE; break;
+			}
+		}
+
 		void UpdateTexture(uint32_t id, olc::Sprite* spr) override
 		{
 			UNUSED(id);
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+			if (spr->GetLayout() != olc::Sprite::Layout::LINEAR)
+			{
+				// GL takes rows, so upload a linear copy
+				std::unique_ptr<olc::Sprite> pLinear(spr->Duplicate());
+				pLinear->SetLayout(olc::Sprite::Layout::LINEAR);
+				UpdateTexture(id, pLinear.get());
+				return;
+			}
+#if defined(OLC_PLATFORM_EMSCRIPTEN)
+			if (spr->GetFormat() != olc::Sprite::Format::RGBA8)
+			{
+				// No one or two channel textures in GLES 2, so expand to RGBA8
+				std::vector<olc::Pixel> vPixels(size_t(spr->width) * size_t(spr->height));
+				olc::Sprite::ConvertPixels(spr->GetFormat(), spr->GetRawData(), olc::Sprite::Format::RGBA8, vPixels.data(), vPixels.size());
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, spr->width, spr->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, vPixels.data());
+				return;
+			}
+#endif
+			GLint nInternal; GLenum nFormat, nType;
+			GetTextureFormat(spr->GetFormat(), nInternal, nFormat, nType);
+			// Rows of one and two byte texels need not be 4 byte aligned
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexImage2D(GL_TEXTURE_2D, 0, nInternal, spr->width, spr->height, 0, nFormat, nType, spr->GetRawData());
 		}
 
 		void ReadTexture(uint32_t id, olc::Sprite* spr) override
 		{
-			glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, spr->GetData());
+			if (spr->GetLayout() != olc::Sprite::Layout::LINEAR)
+			{
+				olc::Sprite linear(spr->width, spr->height, spr->GetFormat());
+				ReadTexture(id, &linear);
+				linear.SetLayout(olc::Sprite::Layout::TILED);
+				spr->pColData = std::move(linear.pColData);
+				return;
+			}
+#if defined(OLC_PLATFORM_EMSCRIPTEN)
+			if (spr->GetFormat() != olc::Sprite::Format::RGBA8)
+			{
+				std::vector<olc::Pixel> vPixels(size_t(spr->width) * size_t(spr->height));
+				glReadPixels(0, 0, spr->width, spr->height, GL_RGBA, GL_UNSIGNED_BYTE, vPixels.data());
+				olc::Sprite::ConvertPixels(olc::Sprite::Format::RGBA8, vPixels.data(), spr->GetFormat(), spr->GetRawData(), vPixels.size());
+				return;
+			}
+#endif
+			GLint nInternal; GLenum nFormat, nType;
+			GetTextureFormat(spr->GetFormat(), nInternal, nFormat, nType);
+			glPixelStorei(GL_PACK_ALIGNMENT, 1);
+			glReadPixels(0, 0, spr->width, spr->height, nFormat, nType, spr->GetRawData());
 		}
 
 		void ApplyTexture(uint32_t id) override
 		{
+			// Always binds, this also resyncs after a layer hook drew with GL
 			glBindTexture(GL_TEXTURE_2D, id);
+			nBoundTexture = id;
 		}
 
 		void ClearBuffer(olc::Pixel p, bool bDepth) override
@@ -4056,7 +7719,8 @@ namespace olc
 			spr->width = bmp->GetWidth();
 			spr->height = bmp->GetHeight();
 
-			spr->pColData.resize(spr->width * spr->height);
+			// Every pixel is written below, so skip filling it first
+			spr->pColData.allocate_uninitialised(spr->width * spr->height);
 
 			for (int y = 0; y < spr->height; y++)
 				for (int x = 0; x < spr->width; x++)
@@ -4113,15 +7777,17 @@ namespace olc
 			// https://gist.github.com/niw/5963798
 			// Also reading png from streams
 			// http://www.piko3d.net/tutorials/libpng-tutorial-loading-png-files-from-streams/
-			png_structp png;
-			png_infop info;
+			// All libpng state lives in png/info, so concurrent loads are safe.
+			// f is volatile as it changes between setjmp() and a possible longjmp()
+			png_structp png = nullptr;
+			png_infop info = nullptr;
+			FILE* volatile f = nullptr;
 
 			auto loadPNG = [&]()
 			{
 				png_read_info(png, info);
 				png_byte color_type;
 				png_byte bit_depth;
-				png_bytep* row_pointers;
 				spr->width = png_get_image_width(png, info);
 				spr->height = png_get_image_height(png, info);
 				color_type = png_get_color_type(png, info);
@@ -4134,29 +7800,19 @@ namespace olc
 					png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
 				if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
 					png_set_gray_to_rgb(png);
+				int nPasses = png_set_interlace_handling(png);
 				png_read_update_info(png, info);
-				row_pointers = (png_bytep*)malloc(sizeof(png_bytep) * spr->height);
-				for (int y = 0; y < spr->height; y++) {
-					row_pointers[y] = (png_byte*)malloc(png_get_rowbytes(png, info));
-				}
-				png_read_image(png, row_pointers);
+				// The transforms above always yield 8 bit RGBA, which is exactly
+				// the memory layout of olc::Pixel
+				if (png_get_rowbytes(png, info) != size_t(spr->width) * sizeof(olc::Pixel))
+					png_error(png, "unexpected row size");
 				////////////////////////////////////////////////////////////////////////////
-				// Create sprite array
-				spr->pColData.resize(spr->width * spr->height);
-				// Iterate through image rows, converting into sprite format
-				for (int y = 0; y < spr->height; y++)
-				{
-					png_bytep row = row_pointers[y];
-					for (int x = 0; x < spr->width; x++)
-					{
-						png_bytep px = &(row[x * 4]);
-						spr->SetPixel(x, y, Pixel(px[0], px[1], px[2], px[3]));
-					}
-				}
-
-				for (int y = 0; y < spr->height; y++) // Thanks maksym33
-					free(row_pointers[y]);
-				free(row_pointers);
+				// Decode rows straight into the sprite, interlaced images revisit
+				// each row once per pass and merge into what is already there
+				spr->pColData.allocate_uninitialised(size_t(spr->width) * size_t(spr->height));
+				for (int pass = 0; pass < nPasses; pass++)
+					for (int y = 0; y < spr->height; y++)
+						png_read_row(png, (png_bytep)(spr->pColData.data() + size_t(y) * spr->width), nullptr);
 				png_destroy_read_struct(&png, &info, nullptr);
 			};
 
@@ -4170,8 +7826,12 @@ namespace olc
 
 			if (pack == nullptr)
 			{
-				FILE* f = fopen(sImageFile.c_str(), "rb");
-				if (!f) return olc::rcode::NO_FILE;
+				f = fopen(sImageFile.c_str(), "rb");
+				if (!f)
+				{
+					png_destroy_read_struct(&png, &info, nullptr);
+					return olc::rcode::NO_FILE;
+				}
 				png_init_io(png, f);
 				loadPNG();
 				fclose(f);
@@ -4187,6 +7847,8 @@ namespace olc
 			return olc::rcode::OK;
 
 		fail_load:
+			if (f) fclose(f);
+			if (png) png_destroy_read_struct(&png, info ? &info : nullptr, nullptr);
 			spr->width = 0;
 			spr->height = 0;
 			spr->pColData.clear();
@@ -4231,6 +7893,8 @@ namespace olc
 		olc::rcode LoadImageResource(olc::Sprite* spr, const std::string& sImageFile, olc::ResourcePack* pack) override
 		{
 			UNUSED(pack);
+			// stb_image keeps decoder state per call, only its failure reason
+			// string is global, so concurrent loads are fine
 			// clear out existing sprite
 			spr->pColData.clear();
 			// Open file
@@ -4250,9 +7914,10 @@ namespace olc
 
 			if (!bytes) return olc::rcode::FAIL;
 			spr->width = w; spr->height = h;
-			spr->pColData.resize(spr->width * spr->height);
-			std::memcpy(spr->pColData.data(), bytes, spr->width * spr->height * 4);
-			delete[] bytes;
+			// 4 requested channels are RGBA, so the sprite takes the decoded
+			// buffer over as is, stb must be the one to free it though
+			spr->pColData.adopt((olc::Pixel*)bytes, size_t(w) * size_t(h),
+				[](olc::Pixel* p) { stbi_image_free(p); });
 			return olc::rcode::OK;
 		}
 
@@ -4805,6 +8470,7 @@ namespace olc {
 
 		static void DrawFunct() {
 			ptrPGE->olc_CoreUpdate();
+			ptrPGE->olc_PaceFrame();
 		}
 
 		virtual olc::rcode CreateWindowPane(const olc::vi2d& vWindowPos, olc::vi2d& vWindowSize, bool bFullScreen) override